@@ -31,6 +31,7 @@ struct AppConfig {
     int fpsLimit = 0;  // 0 = 不限制
     BackendType renderBackend = BackendType::OpenGL;
     int msaaSamples = 0;
+    int jobThreads = -1;  // 任务系统工作线程数：-1 = CPU 核心数 - 1，0 = 不创建工作线程
 };
 
 // ============================================================================
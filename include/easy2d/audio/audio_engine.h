@@ -24,10 +24,10 @@ public:
     bool initialize();
     void shutdown();
 
-    std::shared_ptr<Sound> loadSound(const std::string& filePath);
-    std::shared_ptr<Sound> loadSound(const std::string& name, const std::string& filePath);
+    Ptr<Sound> loadSound(const std::string& filePath);
+    Ptr<Sound> loadSound(const std::string& name, const std::string& filePath);
 
-    std::shared_ptr<Sound> getSound(const std::string& name);
+    Ptr<Sound> getSound(const std::string& name);
     void unloadSound(const std::string& name);
     void unloadAllSounds();
 
@@ -46,7 +46,7 @@ private:
 
     ma_engine* engine_ = nullptr;
     // 使用 shared_ptr 存储，确保在 AudioEngine 销毁前所有 Sound 都被销毁
-    std::unordered_map<std::string, std::shared_ptr<Sound>> sounds_;
+    std::unordered_map<std::string, Ptr<Sound>> sounds_;
     float masterVolume_ = 1.0f;
 };
 
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <easy2d/core/math_types.h>
+#include <glm/mat4x4.hpp>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define E2D_AFFINE_SSE 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define E2D_AFFINE_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace easy2d {
+
+// ---------------------------------------------------------------------------
+// 2D 仿射变换（6 个 float，列主序，与 glm 一致）
+//
+//   | a  c  tx |
+//   | b  d  ty |
+//   | 0  0  1  |
+//
+// 线性部分 (a, b, c, d) 连续存放，组合与求逆时可整体装入一个 SIMD 寄存器
+// ---------------------------------------------------------------------------
+struct alignas(8) Affine2D {
+    float m[6] = {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};   // a, b, c, d, tx, ty
+
+    Affine2D() = default;
+    Affine2D(float a, float b, float c, float d, float tx, float ty) : m{a, b, c, d, tx, ty} {}
+
+    static Affine2D identity() { return Affine2D{}; }
+
+    static Affine2D translation(float x, float y) {
+        return Affine2D(1.0f, 0.0f, 0.0f, 1.0f, x, y);
+    }
+
+    static Affine2D rotation(float degrees) {
+        float r = degrees * DEG_TO_RAD;
+        float c = std::cos(r);
+        float s = std::sin(r);
+        return Affine2D(c, s, -s, c, 0.0f, 0.0f);
+    }
+
+    static Affine2D scaling(float sx, float sy) {
+        return Affine2D(sx, 0.0f, 0.0f, sy, 0.0f, 0.0f);
+    }
+
+    /// 按 平移 * 旋转 * 斜切 * 缩放 的顺序构建节点局部变换
+    /// （锚点与内容尺寸相关，由具体节点在绘制内容时处理）
+    static Affine2D fromTRSK(const Vec2& position, float rotationDeg, const Vec2& scale, const Vec2& skewDeg) {
+        float cosR = 1.0f, sinR = 0.0f;
+        if (rotationDeg != 0.0f) {
+            float r = rotationDeg * DEG_TO_RAD;
+            cosR = std::cos(r);
+            sinR = std::sin(r);
+        }
+        float kx = skewDeg.x != 0.0f ? std::tan(skewDeg.x * DEG_TO_RAD) : 0.0f;
+        float ky = skewDeg.y != 0.0f ? std::tan(skewDeg.y * DEG_TO_RAD) : 0.0f;
+
+        float a = (cosR - sinR * ky) * scale.x;
+        float b = (sinR + cosR * ky) * scale.x;
+        float c = (cosR * kx - sinR) * scale.y;
+        float d = (sinR * kx + cosR) * scale.y;
+        return Affine2D(a, b, c, d, position.x, position.y);
+    }
+
+    float a() const { return m[0]; }
+    float b() const { return m[1]; }
+    float c() const { return m[2]; }
+    float d() const { return m[3]; }
+    float tx() const { return m[4]; }
+    float ty() const { return m[5]; }
+
+    /// 组合变换：先应用 rhs，再应用 *this
+    Affine2D operator*(const Affine2D& rhs) const {
+        Affine2D r;
+        multiply(*this, rhs, r);
+        return r;
+    }
+
+    Affine2D& operator*=(const Affine2D& rhs) {
+        Affine2D r;
+        multiply(*this, rhs, r);
+        *this = r;
+        return *this;
+    }
+
+    static void multiply(const Affine2D& l, const Affine2D& r, Affine2D& out) {
+#if defined(E2D_AFFINE_SSE)
+        // out.abcd = (la, lb, la, lb) * (ra, ra, rc, rc) + (lc, ld, lc, ld) * (rb, rb, rd, rd)
+        __m128 lin = _mm_loadu_ps(l.m);
+        __m128 rin = _mm_loadu_ps(r.m);
+        __m128 lab = _mm_movelh_ps(lin, lin);
+        __m128 lcd = _mm_movehl_ps(lin, lin);
+        __m128 rac = _mm_shuffle_ps(rin, rin, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 rbd = _mm_shuffle_ps(rin, rin, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 linear = _mm_add_ps(_mm_mul_ps(lab, rac), _mm_mul_ps(lcd, rbd));
+
+        // out.t = (la, lb) * rtx + (lc, ld) * rty + (ltx, lty)
+        __m128 rtx = _mm_set1_ps(r.m[4]);
+        __m128 rty = _mm_set1_ps(r.m[5]);
+        __m128 lt = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(l.m + 4)));
+        __m128 t = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lab, rtx), _mm_mul_ps(lcd, rty)), lt);
+
+        _mm_storeu_ps(out.m, linear);
+        _mm_store_sd(reinterpret_cast<double*>(out.m + 4), _mm_castps_pd(t));
+#elif defined(E2D_AFFINE_NEON)
+        float32x2_t lab = vld1_f32(l.m);
+        float32x2_t lcd = vld1_f32(l.m + 2);
+        float32x2_t col0 = vmla_n_f32(vmul_n_f32(lab, r.m[0]), lcd, r.m[1]);
+        float32x2_t col1 = vmla_n_f32(vmul_n_f32(lab, r.m[2]), lcd, r.m[3]);
+        float32x2_t t = vadd_f32(vmla_n_f32(vmul_n_f32(lab, r.m[4]), lcd, r.m[5]), vld1_f32(l.m + 4));
+        vst1_f32(out.m, col0);
+        vst1_f32(out.m + 2, col1);
+        vst1_f32(out.m + 4, t);
+#else
+        float a = l.m[0] * r.m[0] + l.m[2] * r.m[1];
+        float b = l.m[1] * r.m[0] + l.m[3] * r.m[1];
+        float c = l.m[0] * r.m[2] + l.m[2] * r.m[3];
+        float d = l.m[1] * r.m[2] + l.m[3] * r.m[3];
+        float tx = l.m[0] * r.m[4] + l.m[2] * r.m[5] + l.m[4];
+        float ty = l.m[1] * r.m[4] + l.m[3] * r.m[5] + l.m[5];
+        out.m[0] = a; out.m[1] = b; out.m[2] = c; out.m[3] = d; out.m[4] = tx; out.m[5] = ty;
+#endif
+    }
+
+    /// 逆变换（不可逆时返回单位变换）
+    Affine2D inverse() const {
+        float det = m[0] * m[3] - m[1] * m[2];
+        if (det == 0.0f) {
+            return Affine2D{};
+        }
+        float invDet = 1.0f / det;
+
+        Affine2D r;
+#if defined(E2D_AFFINE_SSE)
+        // (a, b, c, d) -> (d, -b, -c, a) / det
+        __m128 lin = _mm_loadu_ps(m);
+        __m128 swapped = _mm_shuffle_ps(lin, lin, _MM_SHUFFLE(0, 2, 1, 3));
+        __m128 sign = _mm_set_ps(1.0f, -1.0f, -1.0f, 1.0f);
+        __m128 inv = _mm_mul_ps(_mm_mul_ps(swapped, sign), _mm_set1_ps(invDet));
+        _mm_storeu_ps(r.m, inv);
+#else
+        r.m[0] = m[3] * invDet;
+        r.m[1] = -m[1] * invDet;
+        r.m[2] = -m[2] * invDet;
+        r.m[3] = m[0] * invDet;
+#endif
+        r.m[4] = -(r.m[0] * m[4] + r.m[2] * m[5]);
+        r.m[5] = -(r.m[1] * m[4] + r.m[3] * m[5]);
+        return r;
+    }
+
+    Vec2 transformPoint(const Vec2& p) const {
+        return Vec2(m[0] * p.x + m[2] * p.y + m[4],
+                    m[1] * p.x + m[3] * p.y + m[5]);
+    }
+
+    Vec2 transformVector(const Vec2& v) const {
+        return Vec2(m[0] * v.x + m[2] * v.y,
+                    m[1] * v.x + m[3] * v.y);
+    }
+
+    /// 变换轴对齐矩形的四个角（左上、右上、右下、左下），四个角在同一组 SIMD 指令中完成
+    void transformCorners(const Rect& rect, float outX[4], float outY[4]) const {
+        float x0 = rect.origin.x;
+        float y0 = rect.origin.y;
+        float x1 = x0 + rect.size.width;
+        float y1 = y0 + rect.size.height;
+#if defined(E2D_AFFINE_SSE)
+        __m128 lx = _mm_set_ps(x0, x1, x1, x0);
+        __m128 ly = _mm_set_ps(y1, y1, y0, y0);
+        __m128 xs = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(m[0])), _mm_mul_ps(ly, _mm_set1_ps(m[2]))),
+                               _mm_set1_ps(m[4]));
+        __m128 ys = _mm_add_ps(_mm_add_ps(_mm_mul_ps(lx, _mm_set1_ps(m[1])), _mm_mul_ps(ly, _mm_set1_ps(m[3]))),
+                               _mm_set1_ps(m[5]));
+        _mm_storeu_ps(outX, xs);
+        _mm_storeu_ps(outY, ys);
+#elif defined(E2D_AFFINE_NEON)
+        const float cx[4] = {x0, x1, x1, x0};
+        const float cy[4] = {y0, y0, y1, y1};
+        float32x4_t lx = vld1q_f32(cx);
+        float32x4_t ly = vld1q_f32(cy);
+        float32x4_t xs = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[4]), lx, m[0]), ly, m[2]);
+        float32x4_t ys = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[5]), lx, m[1]), ly, m[3]);
+        vst1q_f32(outX, xs);
+        vst1q_f32(outY, ys);
+#else
+        const float cx[4] = {x0, x1, x1, x0};
+        const float cy[4] = {y0, y0, y1, y1};
+        for (int i = 0; i < 4; ++i) {
+            outX[i] = m[0] * cx[i] + m[2] * cy[i] + m[4];
+            outY[i] = m[1] * cx[i] + m[3] * cy[i] + m[5];
+        }
+#endif
+    }
+
+    /// 变换后矩形的轴对齐包围盒
+    Rect transformRectBounds(const Rect& rect) const {
+        float xs[4], ys[4];
+        transformCorners(rect, xs, ys);
+        float minX = std::min(std::min(xs[0], xs[1]), std::min(xs[2], xs[3]));
+        float maxX = std::max(std::max(xs[0], xs[1]), std::max(xs[2], xs[3]));
+        float minY = std::min(std::min(ys[0], ys[1]), std::min(ys[2], ys[3]));
+        float maxY = std::max(std::max(ys[0], ys[1]), std::max(ys[2], ys[3]));
+        return Rect(minX, minY, maxX - minX, maxY - minY);
+    }
+
+    /// 转换为 OpenGL 使用的 4x4 矩阵
+    glm::mat4 toMat4() const {
+        glm::mat4 out(1.0f);
+        out[0][0] = m[0];
+        out[0][1] = m[1];
+        out[1][0] = m[2];
+        out[1][1] = m[3];
+        out[3][0] = m[4];
+        out[3][1] = m[5];
+        return out;
+    }
+};
+
+} // namespace easy2d
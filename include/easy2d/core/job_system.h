@@ -0,0 +1,160 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace easy2d {
+
+using JobFunction = Function<void()>;
+
+class JobCounter;
+
+// ============================================================================
+// 任务
+// ============================================================================
+struct Job {
+    JobFunction function;
+    JobCounter* counter = nullptr;   // 完成后递减，可为空
+};
+
+// ============================================================================
+// 任务计数器 - 记录未完成的任务数，可作为其他任务的依赖
+// 计数器须在所有关联任务完成（wait 返回）之后才能销毁
+// ============================================================================
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return value_.load(std::memory_order_acquire) == 0; }
+    uint32 getValue() const { return value_.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32> value_{0};
+    std::mutex mutex_;
+    std::vector<Job> continuations_;   // 计数归零后才提交的任务
+};
+
+// ============================================================================
+// 工作线程统计（下标 0 为主线程及其他非工作线程）
+// ============================================================================
+struct JobWorkerStats {
+    uint64 jobsExecuted = 0;
+    uint64 jobsStolen = 0;
+    double busySeconds = 0.0;
+    double utilization = 0.0;   // 忙碌时间 / 自上次 resetStats 以来的时长
+};
+
+// ============================================================================
+// 工作窃取任务系统
+// 每个线程拥有一个双端队列：自己从尾部取（后进先出，缓存友好），
+// 空闲时从其他线程队列头部窃取。等待计数器的线程会参与执行任务。
+// ============================================================================
+class JobSystem {
+public:
+    static JobSystem& getInstance();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// threadCount 为工作线程数：-1 = CPU 核心数 - 1，0 = 不创建工作线程（任务在等待时由调用线程执行）
+    bool initialize(int threadCount = -1);
+    void shutdown();
+    bool isInitialized() const { return initialized_; }
+
+    /// 工作线程数（不含主线程）
+    uint32 getWorkerCount() const { return static_cast<uint32>(workers_.size()); }
+
+    // ------------------------------------------------------------------------
+    // 任务提交与等待
+    // ------------------------------------------------------------------------
+    void schedule(JobFunction function, JobCounter* counter = nullptr);
+
+    /// dependency 归零后才提交任务（依赖已完成时立即提交）
+    void scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter = nullptr);
+
+    /// 等待计数器归零；participate 为 true 时当前线程在等待期间执行队列中的任务
+    void wait(JobCounter& counter, bool participate = true);
+
+    /// 将 [begin, end) 按 grainSize 切分并行执行 fn(first, last)，返回时全部完成；
+    /// grainSize 为 0 时按线程数自动切分。未初始化或无工作线程时在当前线程直接执行
+    template<typename Fn>
+    void parallelFor(size_t begin, size_t end, size_t grainSize, Fn&& fn);
+
+    // ------------------------------------------------------------------------
+    // 统计
+    // ------------------------------------------------------------------------
+    std::vector<JobWorkerStats> getWorkerStats() const;
+    void resetStats();
+
+private:
+    JobSystem() = default;
+    ~JobSystem();
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<uint64> jobsExecuted{0};
+        std::atomic<uint64> jobsStolen{0};
+        std::atomic<uint64> busyNanoseconds{0};
+    };
+
+    // queues_[0] 属于主线程及其他非工作线程，queues_[i] 属于 workers_[i - 1]
+    std::vector<UniquePtr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    bool initialized_ = false;
+
+    std::atomic<bool> running_{false};
+    std::atomic<uint32> queuedJobs_{0};
+    std::atomic<uint32> sleepingWorkers_{0};
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+
+    std::atomic<int64> statsStartNanoseconds_{0};
+
+    void workerLoop(uint32 index);
+    void push(Job job);
+    bool popLocal(uint32 index, Job& job);
+    bool steal(uint32 index, Job& job);
+    bool tryExecuteOne(uint32 index);
+    void execute(uint32 index, Job& job, bool stolen);
+    void finish(JobCounter* counter);
+};
+
+template<typename Fn>
+void JobSystem::parallelFor(size_t begin, size_t end, size_t grainSize, Fn&& fn) {
+    if (begin >= end) {
+        return;
+    }
+    size_t count = end - begin;
+    if (grainSize == 0) {
+        // 每个线程约 4 块，兼顾负载均衡与调度开销
+        size_t threads = static_cast<size_t>(getWorkerCount()) + 1;
+        grainSize = std::max<size_t>(1, count / (threads * 4));
+    }
+    if (!initialized_ || workers_.empty() || count <= grainSize) {
+        fn(begin, end);
+        return;
+    }
+
+    // 第一块由调用线程执行，其余块提交到队列
+    JobCounter counter;
+    for (size_t first = begin + grainSize; first < end; first += grainSize) {
+        size_t last = std::min(first + grainSize, end);
+        schedule([&fn, first, last]() { fn(first, last); }, &counter);
+    }
+    fn(begin, begin + grainSize);
+    wait(counter);
+}
+
+} // namespace easy2d
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace easy2d {
+
+// ============================================================================
+// NameId - 驻留字符串 ID
+// 相同内容的名称共享同一个整数 ID，比较与哈希只涉及一个 uint32。
+// 驻留表全局共享、线程安全，空字符串对应无效 ID。
+// str() 不加锁；构造与 find() 需要按字符串查表（读写锁），热路径应缓存 NameId 后再查找。
+// 驻留表只增不减：不要为每个对象或每帧生成不同的名称，批量对象请用标签区分
+// ============================================================================
+class NameId {
+public:
+    static constexpr uint32 INVALID = 0;
+
+    NameId() = default;
+
+    /// 驻留名称（首次出现时加入驻留表）
+    explicit NameId(std::string_view name);
+
+    /// 只查询不驻留：名称从未出现过时返回无效 ID（查找路径等场景不会污染驻留表）
+    static NameId find(std::string_view name);
+
+    uint32 value() const { return id_; }
+    bool isValid() const { return id_ != INVALID; }
+    const std::string& str() const;
+
+    bool operator==(const NameId& other) const { return id_ == other.id_; }
+    bool operator!=(const NameId& other) const { return id_ != other.id_; }
+    bool operator<(const NameId& other) const { return id_ < other.id_; }
+
+private:
+    uint32 id_ = INVALID;
+};
+
+} // namespace easy2d
+
+namespace std {
+
+template<>
+struct hash<easy2d::NameId> {
+    size_t operator()(const easy2d::NameId& id) const noexcept {
+        return std::hash<easy2d::uint32>()(id.value());
+    }
+};
+
+} // namespace std
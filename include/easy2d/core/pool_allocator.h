@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace easy2d {
+
+// ---------------------------------------------------------------------------
+// 分块对象池 - 按 16 字节粒度划分尺寸档位，每档维护空闲链表
+//
+// 内存按 64KB 大块向系统申请，之后只在池内循环使用、不再归还，
+// 大量节点反复创建/销毁时不会产生堆碎片。超过 MAX_BLOCK_SIZE 的请求直接走 operator new。
+// 每档由自旋锁保护，与 Ptr 的引用计数模式无关，可在任意线程分配与释放。
+// ---------------------------------------------------------------------------
+class SlabPool {
+public:
+    static constexpr size_t GRANULARITY = 16;
+    static constexpr size_t MAX_BLOCK_SIZE = 2048;
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    static void* allocate(size_t size);
+    static void deallocate(void* ptr, size_t size);
+
+    // 统计
+    static size_t getLiveBlockCount();
+    static size_t getReservedBytes();
+};
+
+// ---------------------------------------------------------------------------
+// 池分配器 - 供 std::allocate_shared 使用，对象与引用计数位于同一个池块中
+// ---------------------------------------------------------------------------
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if (alignof(T) > SlabPool::GRANULARITY) {
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T*>(SlabPool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (alignof(T) > SlabPool::GRANULARITY) {
+            ::operator delete(ptr);
+            return;
+        }
+        SlabPool::deallocate(ptr, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace easy2d
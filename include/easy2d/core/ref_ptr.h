@@ -0,0 +1,446 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace easy2d {
+
+// ---------------------------------------------------------------------------
+// 单线程引用计数指针
+//
+// 接口对齐 std::shared_ptr / std::weak_ptr / std::enable_shared_from_this 的常用部分，
+// 但计数是普通整数：拷贝与释放只是一次加减，不产生原子操作。
+// 定义 E2D_SINGLE_THREADED_PTR 时 Ptr/WeakPtr/EnableSharedFromThis 即为这里的类型（见 types.h），
+// 此时所有 Ptr 的拷贝、释放都必须在同一线程（主线程）进行。
+// ---------------------------------------------------------------------------
+template<typename T> class RefPtr;
+template<typename T> class RefWeakPtr;
+template<typename T> class RefEnableFromThis;
+
+namespace detail {
+
+// 控制块：全部强引用合计持有一个弱引用，弱引用归零时释放控制块
+class RefBlock {
+public:
+    RefBlock() = default;
+    RefBlock(const RefBlock&) = delete;
+    RefBlock& operator=(const RefBlock&) = delete;
+
+    void addRef() noexcept { ++uses_; }
+    void addWeak() noexcept { ++weaks_; }
+
+    void release() noexcept {
+        if (--uses_ == 0) {
+            destroyObject();
+            releaseWeak();
+        }
+    }
+
+    void releaseWeak() noexcept {
+        if (--weaks_ == 0) {
+            destroyBlock();
+        }
+    }
+
+    bool tryAddRef() noexcept {
+        if (uses_ == 0) {
+            return false;
+        }
+        ++uses_;
+        return true;
+    }
+
+    long useCount() const noexcept { return uses_; }
+
+protected:
+    virtual ~RefBlock() = default;
+    virtual void destroyObject() noexcept = 0;
+    virtual void destroyBlock() noexcept = 0;
+
+private:
+    long uses_ = 1;
+    long weaks_ = 1;
+};
+
+// 接管外部 new 出的对象
+template<typename T>
+class RefBlockPointer final : public RefBlock {
+public:
+    explicit RefBlockPointer(T* ptr) noexcept : ptr_(ptr) {}
+
+private:
+    void destroyObject() noexcept override { delete ptr_; }
+    void destroyBlock() noexcept override { delete this; }
+
+    T* ptr_;
+};
+
+// 对象与控制块位于同一次分配中（makePtr 使用）
+template<typename T, typename Alloc>
+class RefBlockInplace final : public RefBlock {
+public:
+    using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<RefBlockInplace>;
+
+    template<typename... Args>
+    explicit RefBlockInplace(const Alloc& alloc, Args&&... args) : alloc_(alloc) {
+        ::new (static_cast<void*>(&storage_)) T(std::forward<Args>(args)...);
+    }
+
+    T* get() noexcept { return std::launder(reinterpret_cast<T*>(&storage_)); }
+
+private:
+    void destroyObject() noexcept override { get()->~T(); }
+
+    void destroyBlock() noexcept override {
+        BlockAlloc alloc(alloc_);
+        this->~RefBlockInplace();
+        std::allocator_traits<BlockAlloc>::deallocate(alloc, this, 1);
+    }
+
+    Alloc alloc_;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage_;
+};
+
+struct RefAccess;
+
+} // namespace detail
+
+// ---------------------------------------------------------------------------
+// 强引用
+// ---------------------------------------------------------------------------
+template<typename T>
+class RefPtr {
+    template<typename U>
+    using EnableIfConvertible = std::enable_if_t<std::is_convertible_v<U*, T*>, int>;
+
+public:
+    using element_type = T;
+    using weak_type = RefWeakPtr<T>;
+
+    constexpr RefPtr() noexcept = default;
+    constexpr RefPtr(std::nullptr_t) noexcept {}
+
+    /// 接管 new 出的对象（控制块单独分配）
+    template<typename U, EnableIfConvertible<U> = 0>
+    explicit RefPtr(U* ptr) : ptr_(ptr) {
+        if (!ptr) {
+            return;
+        }
+        try {
+            block_ = new detail::RefBlockPointer<U>(ptr);
+        } catch (...) {
+            delete ptr;
+            throw;
+        }
+        enableFromThis(ptr, ptr);
+    }
+
+    /// 别名构造：与 other 共享所有权，但指向 ptr（用于类型转换）
+    template<typename U>
+    RefPtr(const RefPtr<U>& other, T* ptr) noexcept : ptr_(ptr), block_(other.block_) {
+        if (block_) {
+            block_->addRef();
+        }
+    }
+
+    RefPtr(const RefPtr& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        if (block_) {
+            block_->addRef();
+        }
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefPtr(const RefPtr<U>& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        if (block_) {
+            block_->addRef();
+        }
+    }
+
+    RefPtr(RefPtr&& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        other.ptr_ = nullptr;
+        other.block_ = nullptr;
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefPtr(RefPtr<U>&& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        other.ptr_ = nullptr;
+        other.block_ = nullptr;
+    }
+
+    /// 由弱引用构造；对象已销毁时抛出 std::bad_weak_ptr（与 std::shared_ptr 一致）
+    template<typename U, EnableIfConvertible<U> = 0>
+    explicit RefPtr(const RefWeakPtr<U>& weak) {
+        if (!weak.block_ || !weak.block_->tryAddRef()) {
+            throw std::bad_weak_ptr();
+        }
+        ptr_ = weak.ptr_;
+        block_ = weak.block_;
+    }
+
+    ~RefPtr() {
+        if (block_) {
+            block_->release();
+        }
+    }
+
+    RefPtr& operator=(const RefPtr& other) noexcept {
+        RefPtr(other).swap(*this);
+        return *this;
+    }
+
+    RefPtr& operator=(RefPtr&& other) noexcept {
+        RefPtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefPtr& operator=(const RefPtr<U>& other) noexcept {
+        RefPtr(other).swap(*this);
+        return *this;
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefPtr& operator=(RefPtr<U>&& other) noexcept {
+        RefPtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    RefPtr& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    void reset() noexcept { RefPtr().swap(*this); }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    void reset(U* ptr) { RefPtr(ptr).swap(*this); }
+
+    void swap(RefPtr& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+        std::swap(block_, other.block_);
+    }
+
+    T* get() const noexcept { return ptr_; }
+    std::add_lvalue_reference_t<T> operator*() const noexcept { return *ptr_; }
+    T* operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+    long use_count() const noexcept { return block_ ? block_->useCount() : 0; }
+
+    template<typename U>
+    bool owner_before(const RefPtr<U>& other) const noexcept { return block_ < other.block_; }
+
+private:
+    template<typename> friend class RefPtr;
+    template<typename> friend class RefWeakPtr;
+    friend struct detail::RefAccess;
+
+    T* ptr_ = nullptr;
+    detail::RefBlock* block_ = nullptr;
+
+    RefPtr(T* ptr, detail::RefBlock* block) noexcept : ptr_(ptr), block_(block) {}
+
+    // 对象继承 RefEnableFromThis 时记录自身的弱引用
+    template<typename X, typename Y>
+    void enableFromThis(const RefEnableFromThis<X>* base, Y* ptr) noexcept {
+        if (base && base->weakThis_.expired()) {
+            base->weakThis_.assign(static_cast<X*>(ptr), block_);
+        }
+    }
+    void enableFromThis(...) noexcept {}
+};
+
+// ---------------------------------------------------------------------------
+// 弱引用
+// ---------------------------------------------------------------------------
+template<typename T>
+class RefWeakPtr {
+    template<typename U>
+    using EnableIfConvertible = std::enable_if_t<std::is_convertible_v<U*, T*>, int>;
+
+public:
+    using element_type = T;
+
+    constexpr RefWeakPtr() noexcept = default;
+
+    RefWeakPtr(const RefWeakPtr& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        if (block_) {
+            block_->addWeak();
+        }
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefWeakPtr(const RefWeakPtr<U>& other) noexcept : block_(other.block_) {
+        // 对象可能已销毁，经 lock 取指针以避免对悬空指针做基类转换
+        if (block_) {
+            ptr_ = other.lock().get();
+            block_->addWeak();
+        }
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefWeakPtr(const RefPtr<U>& ptr) noexcept : ptr_(ptr.ptr_), block_(ptr.block_) {
+        if (block_) {
+            block_->addWeak();
+        }
+    }
+
+    RefWeakPtr(RefWeakPtr&& other) noexcept : ptr_(other.ptr_), block_(other.block_) {
+        other.ptr_ = nullptr;
+        other.block_ = nullptr;
+    }
+
+    ~RefWeakPtr() {
+        if (block_) {
+            block_->releaseWeak();
+        }
+    }
+
+    RefWeakPtr& operator=(const RefWeakPtr& other) noexcept {
+        RefWeakPtr(other).swap(*this);
+        return *this;
+    }
+
+    RefWeakPtr& operator=(RefWeakPtr&& other) noexcept {
+        RefWeakPtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefWeakPtr& operator=(const RefWeakPtr<U>& other) noexcept {
+        RefWeakPtr(other).swap(*this);
+        return *this;
+    }
+
+    template<typename U, EnableIfConvertible<U> = 0>
+    RefWeakPtr& operator=(const RefPtr<U>& ptr) noexcept {
+        RefWeakPtr(ptr).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { RefWeakPtr().swap(*this); }
+
+    void swap(RefWeakPtr& other) noexcept {
+        std::swap(ptr_, other.ptr_);
+        std::swap(block_, other.block_);
+    }
+
+    RefPtr<T> lock() const noexcept {
+        if (block_ && block_->tryAddRef()) {
+            return RefPtr<T>(ptr_, block_);
+        }
+        return RefPtr<T>();
+    }
+
+    bool expired() const noexcept { return !block_ || block_->useCount() == 0; }
+    long use_count() const noexcept { return block_ ? block_->useCount() : 0; }
+
+    template<typename U>
+    bool owner_before(const RefWeakPtr<U>& other) const noexcept { return block_ < other.block_; }
+
+private:
+    template<typename> friend class RefPtr;
+    template<typename> friend class RefWeakPtr;
+
+    T* ptr_ = nullptr;
+    detail::RefBlock* block_ = nullptr;
+
+    void assign(T* ptr, detail::RefBlock* block) noexcept {
+        RefWeakPtr().swap(*this);
+        ptr_ = ptr;
+        block_ = block;
+        block_->addWeak();
+    }
+};
+
+// ---------------------------------------------------------------------------
+// 由对象自身取得强/弱引用（成员名与 std::enable_shared_from_this 一致）
+// ---------------------------------------------------------------------------
+template<typename T>
+class RefEnableFromThis {
+public:
+    RefPtr<T> shared_from_this() { return RefPtr<T>(weakThis_); }
+    RefPtr<const T> shared_from_this() const { return RefPtr<const T>(weakThis_); }
+    RefWeakPtr<T> weak_from_this() noexcept { return weakThis_; }
+    RefWeakPtr<const T> weak_from_this() const noexcept { return weakThis_; }
+
+protected:
+    constexpr RefEnableFromThis() noexcept = default;
+    RefEnableFromThis(const RefEnableFromThis&) noexcept {}
+    RefEnableFromThis& operator=(const RefEnableFromThis&) noexcept { return *this; }
+    ~RefEnableFromThis() = default;
+
+private:
+    template<typename> friend class RefPtr;
+
+    mutable RefWeakPtr<T> weakThis_;
+};
+
+namespace detail {
+
+struct RefAccess {
+    template<typename T, typename Alloc, typename... Args>
+    static RefPtr<T> allocate(const Alloc& alloc, Args&&... args) {
+        using Block = RefBlockInplace<T, Alloc>;
+        typename Block::BlockAlloc blockAlloc(alloc);
+        Block* block = std::allocator_traits<typename Block::BlockAlloc>::allocate(blockAlloc, 1);
+        try {
+            ::new (static_cast<void*>(block)) Block(alloc, std::forward<Args>(args)...);
+        } catch (...) {
+            std::allocator_traits<typename Block::BlockAlloc>::deallocate(blockAlloc, block, 1);
+            throw;
+        }
+
+        RefPtr<T> result(block->get(), block);
+        result.enableFromThis(result.ptr_, result.ptr_);
+        return result;
+    }
+};
+
+} // namespace detail
+
+/// 以 alloc 分配对象与控制块（一次分配）
+template<typename T, typename Alloc, typename... Args>
+inline RefPtr<T> allocateRef(const Alloc& alloc, Args&&... args) {
+    return detail::RefAccess::allocate<T>(alloc, std::forward<Args>(args)...);
+}
+
+template<typename T, typename... Args>
+inline RefPtr<T> makeRef(Args&&... args) {
+    return detail::RefAccess::allocate<T>(std::allocator<T>(), std::forward<Args>(args)...);
+}
+
+// ---------------------------------------------------------------------------
+// 比较
+// ---------------------------------------------------------------------------
+template<typename T, typename U>
+inline bool operator==(const RefPtr<T>& a, const RefPtr<U>& b) noexcept { return a.get() == b.get(); }
+template<typename T, typename U>
+inline bool operator!=(const RefPtr<T>& a, const RefPtr<U>& b) noexcept { return a.get() != b.get(); }
+template<typename T, typename U>
+inline bool operator<(const RefPtr<T>& a, const RefPtr<U>& b) noexcept {
+    return std::less<const void*>()(a.get(), b.get());
+}
+
+template<typename T>
+inline bool operator==(const RefPtr<T>& a, std::nullptr_t) noexcept { return !a; }
+template<typename T>
+inline bool operator==(std::nullptr_t, const RefPtr<T>& a) noexcept { return !a; }
+template<typename T>
+inline bool operator!=(const RefPtr<T>& a, std::nullptr_t) noexcept { return static_cast<bool>(a); }
+template<typename T>
+inline bool operator!=(std::nullptr_t, const RefPtr<T>& a) noexcept { return static_cast<bool>(a); }
+
+} // namespace easy2d
+
+namespace std {
+
+template<typename T>
+struct hash<easy2d::RefPtr<T>> {
+    size_t operator()(const easy2d::RefPtr<T>& ptr) const noexcept { return hash<T*>()(ptr.get()); }
+};
+
+} // namespace std
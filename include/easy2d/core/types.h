@@ -3,25 +3,97 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <type_traits>
+#include <easy2d/core/pool_allocator.h>
+#include <easy2d/core/ref_ptr.h>
 
 namespace easy2d {
 
 // ---------------------------------------------------------------------------
 // 智能指针别名
+//
+// 默认为标准 shared_ptr。定义 E2D_SINGLE_THREADED_PTR 时改用 RefPtr（非原子引用计数），
+// 适用于只在主线程构建和访问场景的程序：此时任何 Ptr/WeakPtr 都不能在任务线程
+// （JobSystem）或音频回调中拷贝、释放。
+//
+// 该宏会改变所有持有 Ptr 的类型的布局，必须同时作用于库和使用方：
+// 通过 xmake 选项 single_threaded_ptr 开启（宏以 public 方式传给依赖目标），不要只在某一侧手动定义。
+// 两侧设置不一致时链接失败（见下方的模式标记），而不是在运行时出现难以排查的内存错误。
 // ---------------------------------------------------------------------------
+#if defined(E2D_SINGLE_THREADED_PTR)
 template<typename T>
-using Ptr = std::shared_ptr<T>;
+using Ptr = RefPtr<T>;
 
 template<typename T>
-using UniquePtr = std::unique_ptr<T>;
+using WeakPtr = RefWeakPtr<T>;
+
+template<typename T>
+using EnableSharedFromThis = RefEnableFromThis<T>;
+#else
+template<typename T>
+using Ptr = std::shared_ptr<T>;
 
 template<typename T>
 using WeakPtr = std::weak_ptr<T>;
 
-/// 创建 shared_ptr 的便捷函数
+template<typename T>
+using EnableSharedFromThis = std::enable_shared_from_this<T>;
+#endif
+
+// 引用计数模式标记：库在 pool_allocator.cpp 中只定义与自身模式对应的符号，
+// 每个包含本头文件的编译单元都引用当前模式的符号
+namespace detail {
+#if defined(E2D_SINGLE_THREADED_PTR)
+extern const int ptrModeSingleThreaded;
+    #if defined(_MSC_VER)
+        #pragma detect_mismatch("easy2d_ptr_mode", "single_threaded")
+    #elif defined(__GNUC__)
+[[gnu::used]] static const int* const ptrModeCheck = &ptrModeSingleThreaded;
+    #endif
+#else
+extern const int ptrModeAtomic;
+    #if defined(_MSC_VER)
+        #pragma detect_mismatch("easy2d_ptr_mode", "atomic")
+    #elif defined(__GNUC__)
+[[gnu::used]] static const int* const ptrModeCheck = &ptrModeAtomic;
+    #endif
+#endif
+} // namespace detail
+
+template<typename T>
+using UniquePtr = std::unique_ptr<T>;
+
+/// 池分配标记：继承它的类型由 makePtr 从 SlabPool 分配（对象与引用计数同处一个池块）
+struct PoolAllocated {};
+
+/// 创建 Ptr 的便捷函数
 template<typename T, typename... Args>
 inline Ptr<T> makePtr(Args&&... args) {
-    return std::make_shared<T>(std::forward<Args>(args)...);
+#if defined(E2D_SINGLE_THREADED_PTR)
+    if constexpr (std::is_base_of_v<PoolAllocated, T>) {
+        return allocateRef<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    } else {
+        return makeRef<T>(std::forward<Args>(args)...);
+    }
+#else
+    if constexpr (std::is_base_of_v<PoolAllocated, T>) {
+        return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    } else {
+        return std::make_shared<T>(std::forward<Args>(args)...);
+    }
+#endif
+}
+
+/// Ptr 类型转换（两种引用计数模式下通用，代替 std::static_pointer_cast / dynamic_pointer_cast）
+template<typename T, typename U>
+inline Ptr<T> staticPtrCast(const Ptr<U>& ptr) noexcept {
+    return Ptr<T>(ptr, static_cast<T*>(ptr.get()));
+}
+
+template<typename T, typename U>
+inline Ptr<T> dynamicPtrCast(const Ptr<U>& ptr) noexcept {
+    T* cast = dynamic_cast<T*>(ptr.get());
+    return cast ? Ptr<T>(ptr, cast) : Ptr<T>();
 }
 
 /// 创建 unique_ptr 的便捷函数
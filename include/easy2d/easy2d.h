@@ -5,9 +5,13 @@
 
 // Core
 #include <easy2d/core/types.h>
+#include <easy2d/core/pool_allocator.h>
 #include <easy2d/core/string.h>
+#include <easy2d/core/name_id.h>
+#include <easy2d/core/job_system.h>
 #include <easy2d/core/color.h>
 #include <easy2d/core/math_types.h>
+#include <easy2d/core/affine2d.h>
 
 // Platform
 #include <easy2d/platform/window.h>
@@ -27,6 +31,8 @@
 #include <easy2d/scene/shape_node.h>
 #include <easy2d/scene/scene_manager.h>
 #include <easy2d/scene/transition.h>
+#include <easy2d/scene/scene_serializer.h>
+#include <easy2d/scene/prefab.h>
 
 // UI
 #include <easy2d/ui/widget.h>
@@ -59,7 +65,10 @@
 // Spatial
 #include <easy2d/spatial/spatial_index.h>
 #include <easy2d/spatial/quadtree.h>
+#include <easy2d/spatial/loose_quadtree.h>
 #include <easy2d/spatial/spatial_hash.h>
+#include <easy2d/spatial/aabb_tree.h>
+#include <easy2d/spatial/sweep_and_prune.h>
 #include <easy2d/spatial/spatial_manager.h>
 
 // Application
@@ -40,7 +40,8 @@ public:
 
     // 统计
     size_t getListenerCount(EventType type) const;
-    size_t getTotalListenerCount() const;
+    size_t getTotalListenerCount() const { return totalListeners_; }
+    bool hasListeners() const { return totalListeners_ != 0; }
 
 private:
     struct Listener {
@@ -51,6 +52,7 @@ private:
 
     std::unordered_map<EventType, std::vector<Listener>> listeners_;
     ListenerId nextId_;
+    size_t totalListeners_ = 0;
 };
 
 } // namespace easy2d
@@ -4,6 +4,8 @@
 #include <easy2d/core/color.h>
 #include <easy2d/core/string.h>
 #include <easy2d/core/math_types.h>
+#include <string>
+#include <vector>
 
 namespace easy2d {
 
@@ -18,6 +20,47 @@ struct Glyph {
     float bearingX;     // 水平偏移
     float bearingY;     // 垂直偏移
     float advance;      // 前进距离
+    int page = 0;       // 所在图集页索引
+};
+
+// ============================================================================
+// 排版后的字形四边形（相对文字原点，已包含缩放与对齐偏移）
+// ============================================================================
+struct GlyphQuad {
+    float x, y;         // 左上角
+    float w, h;
+    float u0, v0;
+    float u1, v1;
+    int page;           // 所在图集页索引
+};
+
+// ============================================================================
+// 字形网格缓存 - 由 Text 等节点持有，文字/字体/对齐/图集代数不变时直接复用
+// ============================================================================
+struct GlyphRun {
+    static constexpr uint32 NEVER_TOUCHED = 0xFFFFFFFFu;
+
+    std::vector<GlyphQuad> quads;
+    std::vector<char32_t> codepoints;   // 参与渲染的字形，用于刷新图集 LRU
+    uint32 pageMask = 0;                // 使用到的图集页（位掩码）
+    uint32 generation = 0;              // 构建时的图集代数
+    mutable uint32 touchedFrame = NEVER_TOUCHED;
+
+    void clear() {
+        quads.clear();
+        codepoints.clear();
+        pageMask = 0;
+        touchedFrame = NEVER_TOUCHED;
+    }
+};
+
+// ============================================================================
+// 字符区间（闭区间），用于批量预热字形
+// 例如 {0x20, 0x7E} 为 ASCII 可打印字符，{0x4E00, 0x9FFF} 为 CJK 统一汉字
+// ============================================================================
+struct CharRange {
+    char32_t first;
+    char32_t last;
 };
 
 // ============================================================================
@@ -30,8 +73,18 @@ public:
     // 获取字形信息
     virtual const Glyph* getGlyph(char32_t codepoint) const = 0;
     
-    // 获取纹理
+    // 获取纹理（第 0 页）
     virtual class Texture* getTexture() const = 0;
+
+    // 图集页：字形通过 Glyph::page 引用对应页的纹理
+    virtual int getPageCount() const = 0;
+    virtual class Texture* getPageTexture(int page) const = 0;
+
+    // 图集代数：字形被淘汰或重新打包（UV 变化）后递增，用于使外部缓存失效
+    virtual uint32 getGeneration() const = 0;
+
+    // 提交缓存的字形网格时调用：标记其页面与字形仍在使用，避免被淘汰
+    virtual void touchGlyphRun(const GlyphRun& run) const = 0;
     
     // 获取字体大小
     virtual int getFontSize() const = 0;
@@ -46,6 +99,28 @@ public:
     
     // 是否支持 SDF 渲染
     virtual bool isSDF() const = 0;
+
+    // ------------------------------------------------------------------------
+    // 字形预热：在后台线程光栅化，再批量打包进图集，避免首次显示时卡顿
+    // cacheDir 非空时优先读取磁盘缓存，并把新光栅化的字形写回缓存
+    // ------------------------------------------------------------------------
+    virtual void prewarmCodepoints(const std::vector<char32_t>& codepoints,
+                                   const std::string& cacheDir = "") = 0;
+
+    void prewarm(const String& chars, const std::string& cacheDir = "") {
+        std::u32string utf32 = chars.toUtf32();
+        prewarmCodepoints(std::vector<char32_t>(utf32.begin(), utf32.end()), cacheDir);
+    }
+
+    void prewarm(const std::vector<CharRange>& ranges, const std::string& cacheDir = "") {
+        std::vector<char32_t> codepoints;
+        for (const CharRange& range : ranges) {
+            for (uint64 c = range.first; c <= range.last; ++c) {
+                codepoints.push_back(static_cast<char32_t>(c));
+            }
+        }
+        prewarmCodepoints(codepoints, cacheDir);
+    }
 };
 
 } // namespace easy2d
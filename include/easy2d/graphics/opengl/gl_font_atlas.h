@@ -16,6 +16,7 @@ namespace easy2d {
 
 // ============================================================================
 // OpenGL 字体图集实现 - 使用 stb_rect_pack 进行矩形打包
+// 图集按需增加页面（不超过页数预算），页面用尽时按 LRU 淘汰字形
 // ============================================================================
 class GLFontAtlas : public FontAtlas {
 public:
@@ -24,7 +25,11 @@ public:
 
     // FontAtlas 接口实现
     const Glyph* getGlyph(char32_t codepoint) const override;
-    Texture* getTexture() const override { return texture_.get(); }
+    Texture* getTexture() const override { return getPageTexture(0); }
+    int getPageCount() const override { return static_cast<int>(pages_.size()); }
+    Texture* getPageTexture(int page) const override;
+    uint32 getGeneration() const override { return generation_; }
+    void touchGlyphRun(const GlyphRun& run) const override;
     int getFontSize() const override { return fontSize_; }
     float getAscent() const override { return ascent_; }
     float getDescent() const override { return descent_; }
@@ -32,32 +37,141 @@ public:
     float getLineHeight() const override { return ascent_ - descent_ + lineGap_; }
     Vec2 measureText(const String& text) override;
     bool isSDF() const override { return useSDF_; }
+    void prewarmCodepoints(const std::vector<char32_t>& codepoints,
+                           const std::string& cacheDir = "") override;
+
+    // ------------------------------------------------------------------------
+    // 磁盘缓存：键由字体文件哈希、字号与 SDF 参数组成
+    // ------------------------------------------------------------------------
+    std::string getCacheKey() const;
+
+    // ------------------------------------------------------------------------
+    // 页数预算与淘汰策略
+    // ------------------------------------------------------------------------
+    void setMaxPages(int maxPages);
+    int getMaxPages() const { return maxPages_; }
+
+    /// 字形连续多少帧未使用后可被淘汰
+    void setEvictionAge(uint32 frames) { evictionAge_ = frames; }
+    uint32 getEvictionAge() const { return evictionAge_; }
+
+    size_t getCachedGlyphCount() const { return glyphs_.size(); }
+
+    // ------------------------------------------------------------------------
+    // 帧驱动（由渲染器在每帧开始时调用）
+    // 推进全局帧计数，并在空闲帧对图集进行淘汰与重新打包
+    // ------------------------------------------------------------------------
+    static void beginFrameAll();
+
+    /// 上传所有图集的脏区域（由精灵批渲染器在提交绘制前调用）
+    static void flushPendingUploads();
 
 private:
     // 图集配置
     static constexpr int ATLAS_WIDTH = 512;
     static constexpr int ATLAS_HEIGHT = 512;
     static constexpr int PADDING = 2;  // 字形之间的间距
+    static constexpr int DEFAULT_MAX_PAGES = 4;
+    static constexpr int MAX_PAGES = 32;     // GlyphRun::pageMask 的位数
+    static constexpr uint32 DEFAULT_EVICTION_AGE = 600;    // 约 10 秒 @60fps
+    static constexpr uint32 MAINTENANCE_INTERVAL = 30;     // 两次整理之间的最少帧数
+    static constexpr size_t MAX_DIRTY_RECTS = 32;          // 超过后合并为一次整体上传
+
+    // SDF 生成参数（同时写入磁盘缓存头部，参数变化后旧缓存自动失效）
+    static constexpr int SDF_PADDING = 8;
+    static constexpr unsigned char SDF_ONEDGE_VALUE = 128;
+    static constexpr float SDF_PIXEL_DIST_SCALE = 64.0f;
+
+    // 光栅化结果（与图集无关，可在工作线程中生成）
+    struct RasterizedGlyph {
+        char32_t codepoint = 0;
+        Glyph metrics{};
+        int w = 0;
+        int h = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    // 页内脏区域（stb_rect_pack 左上角原点）
+    struct DirtyRect {
+        int x, y, w, h;
+    };
+
+    // 图集页（单通道 R8：位图字形存覆盖率，SDF 字形存距离）
+    struct Page {
+        std::unique_ptr<GLTexture> texture;
+        stbrp_context packContext;
+        std::vector<stbrp_node> packNodes;
+        std::vector<uint8_t> pixels;    // CPU 暂存副本（OpenGL 行序），新字形先写入这里
+        std::vector<DirtyRect> dirtyRects;
+        uint32 lastUsedFrame = 0;
+        int glyphCount = 0;
+    };
+
+    // 缓存的字形及其在页内的位置
+    struct CachedGlyph {
+        Glyph glyph;
+        int x = 0;          // 页内像素坐标（stb_rect_pack 左上角原点，不含 PADDING）
+        int y = 0;
+        int w = 0;
+        int h = 0;
+        uint32 lastUsedFrame = 0;
+    };
 
     int fontSize_;
     bool useSDF_;
-    mutable std::unique_ptr<GLTexture> texture_;
-    mutable std::unordered_map<char32_t, Glyph> glyphs_;
-    
-    // stb_rect_pack 上下文
-    mutable stbrp_context packContext_;
-    mutable std::vector<stbrp_node> packNodes_;
-    mutable int currentY_;
-    
+    int maxPages_ = DEFAULT_MAX_PAGES;
+    uint32 evictionAge_ = DEFAULT_EVICTION_AGE;
+
+    // 页面使用 unique_ptr 保存：stbrp_context 内部持有指向自身的指针，不能移动
+    mutable std::vector<std::unique_ptr<Page>> pages_;
+    mutable std::unordered_map<char32_t, CachedGlyph> glyphs_;
+    mutable uint32 generation_ = 0;
+    mutable uint32 currentFrame_ = 0;
+    mutable uint32 lastMaintenanceFrame_ = 0;
+    mutable bool glyphsAddedThisFrame_ = false;
+    mutable bool fullWarnedThisFrame_ = false;
+
     std::vector<unsigned char> fontData_;
+    mutable uint64 fontHash_ = 0;
     stbtt_fontinfo fontInfo_;
     float scale_;
     float ascent_;
     float descent_;
     float lineGap_;
 
+    static uint32 frameIndex_;
+    static bool uploadsPending_;
+    static std::vector<GLFontAtlas*> liveAtlases_;
+
     void createAtlas();
     void cacheGlyph(char32_t codepoint) const;
+    void rasterizeGlyph(char32_t codepoint, RasterizedGlyph& out) const;
+    void storeGlyph(char32_t codepoint, const Glyph& metrics, const uint8_t* coverage, int w, int h) const;
+    void placeGlyph(char32_t codepoint, const Glyph& metrics, const uint8_t* coverage,
+                    int w, int h, int pageIndex, int x, int y) const;
+
+    // 预热：多线程光栅化与批量打包
+    void rasterizeParallel(const std::vector<char32_t>& codepoints, std::vector<RasterizedGlyph>& out) const;
+    void commitBatch(std::vector<RasterizedGlyph>& glyphs) const;
+    bool loadCacheFile(const std::string& path, std::unordered_map<char32_t, RasterizedGlyph>& out) const;
+    bool saveCacheFile(const std::string& path, const std::unordered_map<char32_t, RasterizedGlyph>& glyphs) const;
+
+    // 页面管理
+    Page& addPage() const;
+    void resetPage(Page& page) const;
+    bool packIntoPage(Page& page, int w, int h, int& x, int& y) const;
+    bool allocateRect(int w, int h, int& pageIndex, int& x, int& y) const;
+    void evictPage(int pageIndex) const;
+    void compactPage(int pageIndex) const;
+    void releaseTrailingPages() const;
+    void onFrameBegin(uint32 frame) const;
+
+    // 像素写入与批量上传
+    void writePixels(Page& page, int x, int y, int w, int h, const uint8_t* coverage) const;
+    void markDirty(Page& page, int x, int y, int w, int h) const;
+    void flushUploads() const;
+    void uploadRegion(const Page& page, const DirtyRect& rect) const;
+    void updateGlyphUV(CachedGlyph& cached) const;
 };
 
 } // namespace easy2d
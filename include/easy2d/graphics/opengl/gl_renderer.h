@@ -36,6 +36,8 @@ public:
     void drawSprite(const Texture& texture, const Rect& destRect, const Rect& srcRect, 
                    const Color& tint, float rotation, const Vec2& anchor) override;
     void drawSprite(const Texture& texture, const Vec2& position, const Color& tint) override;
+    void drawSprite(const Texture& texture, const Rect& localRect, const Rect& srcRect,
+                   const Color& tint, const Affine2D& transform) override;
     void endSpriteBatch() override;
 
     void drawLine(const Vec2& start, const Vec2& end, const Color& color, float width) override;
@@ -51,6 +53,9 @@ public:
     Ptr<FontAtlas> createFontAtlas(const std::string& filepath, int fontSize, bool useSDF = false) override;
     void drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color) override;
     void drawText(const FontAtlas& font, const String& text, float x, float y, const Color& color) override;
+    void drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color,
+                  float scale) override;
+    void drawGlyphRun(const FontAtlas& font, const GlyphRun& run, const Vec2& position, const Color& color) override;
 
     Stats getStats() const override { return stats_; }
     void resetStats() override;
@@ -3,9 +3,12 @@
 #include <easy2d/core/types.h>
 #include <easy2d/core/color.h>
 #include <easy2d/core/math_types.h>
+#include <easy2d/core/affine2d.h>
 #include <easy2d/graphics/texture.h>
+#include <easy2d/graphics/font.h>
 #include <easy2d/graphics/opengl/gl_shader.h>
 #include <glm/mat4x4.hpp>
+#include <array>
 #include <vector>
 
 namespace easy2d {
@@ -18,11 +21,14 @@ public:
     static constexpr size_t MAX_SPRITES = 10000;
     static constexpr size_t VERTICES_PER_SPRITE = 4;
     static constexpr size_t INDICES_PER_SPRITE = 6;
+    // 单个批次可同时绑定的纹理数量（多页字体图集、不同精灵纹理交替时不打断批次）
+    static constexpr size_t MAX_TEXTURE_SLOTS = 8;
 
     struct Vertex {
         glm::vec2 position;
         glm::vec2 texCoord;
         glm::vec4 color;
+        float texIndex;
     };
 
     struct SpriteData {
@@ -44,8 +50,21 @@ public:
 
     void begin(const glm::mat4& viewProjection);
     void draw(const Texture& texture, const SpriteData& data);
+
+    /// 提交一个经世界仿射变换的四边形：localRect 为节点局部空间中的矩形，
+    /// 四个角由 SIMD 一次算出；uv0 对应 localRect 左上角，uv1 对应右下角
+    void drawQuad(const Texture& texture, const Affine2D& transform, const Rect& localRect,
+                  const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color, bool isSDF = false);
+
+    /// 整段提交预先排版好的字形四边形（pageTextures 以 GlyphQuad::page 为下标）
+    /// 页索引越界或页纹理为空的四边形会被跳过
+    void drawGlyphQuads(const GlyphQuad* quads, size_t count, const Texture* const* pageTextures, int pageCount,
+                        const glm::vec2& offset, const glm::vec4& color, bool isSDF);
     void end();
 
+    /// 每次提交绘制前调用（用于上传延迟的纹理数据，例如字体图集脏区域）
+    void setPreFlushCallback(Function<void()> callback) { preFlushCallback_ = std::move(callback); }
+
     // 统计
     uint32_t getDrawCallCount() const { return drawCallCount_; }
     uint32_t getSpriteCount() const { return spriteCount_; }
@@ -59,15 +78,19 @@ private:
     std::vector<Vertex> vertices_;
     std::vector<GLuint> indices_;
     
-    const Texture* currentTexture_;
+    std::array<const Texture*, MAX_TEXTURE_SLOTS> textureSlots_;
+    size_t textureSlotCount_;
     bool currentIsSDF_;
     glm::mat4 viewProjection_;
+    Function<void()> preFlushCallback_;
     
     uint32_t drawCallCount_;
     uint32_t spriteCount_;
 
     void flush();
     void setupShader();
+    int acquireTextureSlot(const Texture& texture);
+    int prepareQuad(const Texture& texture, bool isSDF);
 };
 
 } // namespace easy2d
@@ -4,6 +4,7 @@
 #include <easy2d/core/color.h>
 #include <easy2d/core/math_types.h>
 #include <easy2d/core/string.h>
+#include <easy2d/core/affine2d.h>
 #include <glm/mat4x4.hpp>
 
 namespace easy2d {
@@ -12,6 +13,7 @@ namespace easy2d {
 class Window;
 class Texture;
 class FontAtlas;
+struct GlyphRun;
 class Shader;
 
 // ============================================================================
@@ -81,6 +83,13 @@ public:
     virtual void drawSprite(const Texture& texture,
                            const Vec2& position,
                            const Color& tint) = 0;
+    /// 以世界仿射变换绘制：localRect 为节点局部空间中的目标矩形（已含锚点偏移），
+    /// srcRect 宽高为负时表示翻转
+    virtual void drawSprite(const Texture& texture,
+                           const Rect& localRect,
+                           const Rect& srcRect,
+                           const Color& tint,
+                           const Affine2D& transform) = 0;
     virtual void endSpriteBatch() = 0;
 
     // ------------------------------------------------------------------------
@@ -102,6 +111,11 @@ public:
     virtual Ptr<FontAtlas> createFontAtlas(const std::string& filepath, int fontSize, bool useSDF = false) = 0;
     virtual void drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color) = 0;
     virtual void drawText(const FontAtlas& font, const String& text, float x, float y, const Color& color) = 0;
+    /// 按比例缩放字形与行距绘制（用于与字号无关的 SDF 字体）
+    virtual void drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color,
+                          float scale) = 0;
+    /// 绘制缓存的字形网格（由 Text 节点排版并缓存）
+    virtual void drawGlyphRun(const FontAtlas& font, const GlyphRun& run, const Vec2& position, const Color& color) = 0;
 
     // ------------------------------------------------------------------------
     // 统计信息
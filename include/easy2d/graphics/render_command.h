@@ -2,6 +2,7 @@
 
 #include <easy2d/core/types.h>
 #include <easy2d/core/math_types.h>
+#include <easy2d/core/affine2d.h>
 #include <easy2d/core/color.h>
 #include <easy2d/core/string.h>
 #include <variant>
@@ -35,11 +36,12 @@ enum class RenderCommandType {
 // ============================================================================
 struct SpriteData {
     Ptr<Texture> texture;
-    Rect destRect;
+    Rect destRect;          // transform 非单位时为节点局部空间矩形（已含锚点偏移）
     Rect srcRect;
     Color tint;
     float rotation;
     Vec2 anchor;
+    Affine2D transform;     // 节点世界变换
 };
 
 // ============================================================================
@@ -100,6 +102,7 @@ struct TextData {
     String text;
     Vec2 position;
     Color color;
+    float scale = 1.0f;     // 字形缩放（共享 SDF 字体按节点字号缩放）
 };
 
 // ============================================================================
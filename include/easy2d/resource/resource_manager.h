@@ -59,6 +59,9 @@ public:
     
     /// 卸载指定纹理
     void unloadTexture(const std::string& key);
+
+    /// 反查已缓存纹理的 key；纹理不是经由本管理器加载时返回空字符串
+    std::string getTextureKey(const Texture* texture) const;
     
     // ------------------------------------------------------------------------
     // Alpha遮罩资源
@@ -79,6 +82,13 @@ public:
     
     /// 加载字体图集（带缓存）
     Ptr<FontAtlas> loadFont(const std::string& filepath, int fontSize, bool useSDF = false);
+
+    /// 加载与字号无关的 SDF 字体：同一字体文件只创建一个图集（以参考字号光栅化），
+    /// 各 Text 节点通过 setFontSize 缩放字形与度量
+    Ptr<FontAtlas> loadSDFFont(const std::string& filepath);
+
+    /// 共享 SDF 字体的参考光栅化字号
+    static constexpr int SDF_REFERENCE_FONT_SIZE = 48;
     
     /// 通过key获取已缓存的字体图集
     Ptr<FontAtlas> getFont(const std::string& key) const;
@@ -89,6 +99,12 @@ public:
     /// 卸载指定字体
     void unloadFont(const std::string& key);
 
+    /// 反查已缓存字体图集的 key；字体不是经由本管理器加载时返回空字符串
+    std::string getFontKey(const FontAtlas* font) const;
+
+    /// 按 getFontKey 返回的 key 重新加载字体（用于场景文件等持久化引用）
+    Ptr<FontAtlas> loadFontByKey(const std::string& key);
+
     // ------------------------------------------------------------------------
     // 音效资源
     // ------------------------------------------------------------------------
@@ -131,8 +147,11 @@ public:
     ResourceManager(const ResourceManager&) = delete;
     ResourceManager& operator=(const ResourceManager&) = delete;
 
-    // 生成字体缓存key
+    // 生成字体缓存key（fontSize <= 0 表示与字号无关的共享 SDF 字体）
     std::string makeFontKey(const std::string& filepath, int fontSize, bool useSDF) const;
+
+    // 按 key 查找或创建字体图集（调用方持有 fontMutex_）
+    Ptr<FontAtlas> loadFontLocked(const std::string& key, const std::string& filepath, int fontSize, bool useSDF);
     
     // 互斥锁保护缓存
     mutable std::mutex textureMutex_;
@@ -2,11 +2,17 @@
 
 #include <easy2d/core/types.h>
 #include <easy2d/core/math_types.h>
+#include <easy2d/core/affine2d.h>
+#include <easy2d/core/name_id.h>
+#include <easy2d/scene/transform_store.h>
 #include <easy2d/core/color.h>
 #include <easy2d/graphics/render_backend.h>
 #include <easy2d/event/event_dispatcher.h>
 #include <vector>
+#include <unordered_map>
 #include <string>
+#include <string_view>
+#include <iterator>
 #include <functional>
 #include <algorithm>
 
@@ -17,14 +23,17 @@ class Scene;
 class Action;
 class RenderBackend;
 struct RenderCommand;
+class NodeTagView;
 
 // ============================================================================
 // 节点基类 - 场景图的基础
 // ============================================================================
-class Node : public std::enable_shared_from_this<Node> {
+class Node : public EnableSharedFromThis<Node>, public PoolAllocated {
 public:
     Node();
     virtual ~Node();
+    Node(const Node&) = delete;
+    Node& operator=(const Node&) = delete;
 
     // ------------------------------------------------------------------------
     // 层级管理
@@ -34,34 +43,48 @@ public:
     void removeChildByName(const std::string& name);
     void removeFromParent();
     void removeAllChildren();
+
+    /// 预留子节点容量（批量添加前调用）
+    void reserveChildren(size_t count) { children_.reserve(count); }
     
     Ptr<Node> getParent() const { return parent_.lock(); }
+    /// 按 zOrder 升序（同 zOrder 按添加顺序）排列，渲染与命中测试直接使用该顺序
     const std::vector<Ptr<Node>>& getChildren() const { return children_; }
+    /// 同名/同标签的子节点有多个时，返回子节点列表中的第一个
+    /// 字符串版本需查询全局驻留表（读锁），每帧调用时应缓存 NameId 使用下一个重载
     Ptr<Node> getChildByName(const std::string& name) const;
+    Ptr<Node> getChildByName(NameId name) const;
     Ptr<Node> getChildByTag(int tag) const;
 
+    /// 按路径逐级查找后代（如 "ui/hud/score"），不分配内存
+    Ptr<Node> findByPath(std::string_view path) const;
+
+    /// 子树（不含自身）中指定标签的所有节点，按层级先序遍历；
+    /// 返回的视图不分配内存，层级结构变化或帧更新（可能压缩下标）后失效
+    NodeTagView getDescendantsByTag(int tag) const;
+
     // ------------------------------------------------------------------------
     // 变换属性
     // ------------------------------------------------------------------------
     void setPosition(const Vec2& pos);
     void setPosition(float x, float y);
-    Vec2 getPosition() const { return position_; }
+    Vec2 getPosition() const { return transforms().getPosition(transformIndex_); }
 
     void setRotation(float degrees);
-    float getRotation() const { return rotation_; }
+    float getRotation() const { return transforms().getRotation(transformIndex_); }
 
     void setScale(const Vec2& scale);
     void setScale(float scale);
     void setScale(float x, float y);
-    Vec2 getScale() const { return scale_; }
+    Vec2 getScale() const { return transforms().getScale(transformIndex_); }
 
     void setAnchor(const Vec2& anchor);
     void setAnchor(float x, float y);
-    Vec2 getAnchor() const { return anchor_; }
+    Vec2 getAnchor() const { return transforms().getAnchor(transformIndex_); }
 
     void setSkew(const Vec2& skew);
     void setSkew(float x, float y);
-    Vec2 getSkew() const { return skew_; }
+    Vec2 getSkew() const { return transforms().getSkew(transformIndex_); }
 
     void setOpacity(float opacity);
     float getOpacity() const { return opacity_; }
@@ -74,20 +97,26 @@ public:
 
     // ------------------------------------------------------------------------
     // 世界变换
+    // 修改变换属性时只标记脏，并沿子树向下传播；世界变换在下次访问时惰性计算，
+    // 同一帧内多次修改只会重新计算一次
     // ------------------------------------------------------------------------
     Vec2 convertToWorldSpace(const Vec2& localPos) const;
     Vec2 convertToNodeSpace(const Vec2& worldPos) const;
     
-    glm::mat4 getLocalTransform() const;
-    glm::mat4 getWorldTransform() const;
+    Affine2D getLocalTransform() const;
+    Affine2D getWorldTransform() const;
+    glm::mat4 getWorldMatrix() const { return getWorldTransform().toMat4(); }
 
     // ------------------------------------------------------------------------
     // 名称和标签
     // ------------------------------------------------------------------------
-    void setName(const std::string& name) { name_ = name; }
-    const std::string& getName() const { return name_; }
+    // 名称只以驻留 ID 保存，节点本身不持有字符串
+    void setName(const std::string& name);
+    void setName(NameId name);
+    const std::string& getName() const { return nameId_.str(); }
+    NameId getNameId() const { return nameId_; }
     
-    void setTag(int tag) { tag_ = tag; }
+    void setTag(int tag);
     int getTag() const { return tag_; }
 
     // ------------------------------------------------------------------------
@@ -110,6 +139,8 @@ public:
     bool isSpatialIndexed() const { return spatialIndexed_; }
     
     // 更新空间索引（手动调用，通常在边界框变化后）
+    // 只把节点登记为待提交，场景在下一次空间查询前或本帧更新结束时统一提交；
+    // 变换属性的修改会自动登记整棵子树（子节点的世界包围盒依赖祖先变换）
     void updateSpatialIndex();
 
     // ------------------------------------------------------------------------
@@ -122,10 +153,26 @@ public:
     Ptr<Action> getActionByTag(int tag) const;
     size_t getActionCount() const { return actions_.size(); }
 
+    // ------------------------------------------------------------------------
+    // 更新注册
+    // 场景每帧只遍历自己的更新列表，而不是整棵节点树。节点在以下情况进入列表：
+    // wantsUpdate() 返回 true、有运行中的动作、或显式调用 scheduleUpdate。
+    // 重写 onUpdateNode / onUpdate 的非场景节点需要重写 wantsUpdate 或调用 scheduleUpdate
+    // ------------------------------------------------------------------------
+    void scheduleUpdate(int priority = 0);
+    void unscheduleUpdate();
+    bool isUpdateScheduled() const { return updateScheduled_; }
+    int getUpdatePriority() const { return updatePriority_; }
+    bool isUpdateRegistered() const { return updateSlot_ != INVALID_UPDATE_SLOT; }
+
     // ------------------------------------------------------------------------
     // 事件系统
+    // 分发器在首次访问时才创建：绝大多数节点从不注册监听器，
+    // 只读场景（命中测试、事件派发）应使用 hasEventListeners / findEventDispatcher
     // ------------------------------------------------------------------------
-    EventDispatcher& getEventDispatcher() { return eventDispatcher_; }
+    EventDispatcher& getEventDispatcher();
+    EventDispatcher* findEventDispatcher() const { return eventDispatcher_.get(); }
+    bool hasEventListeners() const { return eventDispatcher_ && eventDispatcher_->hasListeners(); }
 
     // ------------------------------------------------------------------------
     // 内部方法
@@ -144,39 +191,62 @@ protected:
     // 子类重写
     virtual void onDraw(RenderBackend& renderer) {}
     virtual void onUpdateNode(float dt) {}
+    /// 子类有逐帧逻辑时返回 true（与 scheduleUpdate 等效，但随类型固定）
+    virtual bool wantsUpdate() const { return false; }
     virtual void generateRenderCommand(std::vector<RenderCommand>& commands, int zOrder) {};
 
     // 供子类访问的内部状态
-    Vec2& getPositionRef() { return position_; }
-    Vec2& getScaleRef() { return scale_; }
-    Vec2& getAnchorRef() { return anchor_; }
-    float getRotationRef() { return rotation_; }
+    // 引用指向 TransformStore 内部数组，仅可短暂使用；修改后需调用 markTransformDirty()
+    Vec2& getPositionRef() { return transforms().positionRef(transformIndex_); }
+    Vec2& getScaleRef() { return transforms().scaleRef(transformIndex_); }
+    Vec2& getAnchorRef() { return transforms().anchorRef(transformIndex_); }
+    float getRotationRef() { return transforms().getRotation(transformIndex_); }
+    void markTransformDirty() { transforms().markDirty(transformIndex_); markSpatialSubtreeDirty(); }
     float getOpacityRef() { return opacity_; }
 
 private:
     // 层级
     WeakPtr<Node> parent_;
-    std::vector<Ptr<Node>> children_;
-    bool childrenOrderDirty_ = false;
-
-    // 变换
-    Vec2 position_ = Vec2::Zero();
-    float rotation_ = 0.0f;
-    Vec2 scale_ = Vec2(1.0f, 1.0f);
-    Vec2 anchor_ = Vec2(0.5f, 0.5f);
-    Vec2 skew_ = Vec2::Zero();
+    std::vector<Ptr<Node>> children_;   // 始终按 zOrder 稳定有序
+
+    // 子节点较多时建立的名称/标签哈希索引（按需创建，随增删子节点维护）
+    // 每个键对应的节点按子节点列表中的顺序排列，查找结果与线性扫描一致（返回第一个）；
+    // 默认标签不建立索引，避免所有未设标签的子节点挤在同一个键下
+    static constexpr size_t CHILD_INDEX_THRESHOLD = 16;
+    struct ChildIndex {
+        std::unordered_map<NameId, std::vector<Node*>> byName;
+        std::unordered_map<int, std::vector<Node*>> byTag;
+    };
+    UniquePtr<ChildIndex> childIndex_;
+
+    // 子节点列表按 (zOrder_, childSeq_) 有序：加入或调整 zOrder 时取父节点的下一个序号
+    uint64 childSeq_ = 0;
+    uint64 nextChildSeq_ = 0;
+
+    void reorderChild(Node* child, int oldZOrder);
+    void buildChildIndex();
+    void indexChild(Node* child);
+    void unindexChild(Node* child);
+    static bool childBefore(const Node* a, const Node* b);   // 子节点列表中的先后顺序
+    Node* findChild(NameId name) const;
+
+    // 变换（位置、旋转、缩放等保存在 TransformStore 中，节点只持有下标）
+    friend class TransformStore;
+    uint32 transformIndex_ = TransformStore::INVALID_INDEX;
+    static TransformStore& transforms() { return TransformStore::getInstance(); }
+
     float opacity_ = 1.0f;
     bool visible_ = true;
     int zOrder_ = 0;
 
-    // 缓存
-    mutable bool transformDirty_ = true;
-    mutable glm::mat4 localTransform_;
-    mutable glm::mat4 worldTransform_;
 
     // 元数据
-    std::string name_;
-    int tag_ = -1;
+    NameId nameId_;
+    static constexpr int DEFAULT_TAG = -1;
+    int tag_ = DEFAULT_TAG;
+
+    // 预制体实例化时直接成员式写入上面的属性与变换（节点尚未挂接，无需维护索引）
+    friend class Prefab;
 
     // 状态
     bool running_ = false;
@@ -187,8 +257,72 @@ private:
     // 动作
     std::vector<Ptr<Action>> actions_;
 
-    // 事件
-    EventDispatcher eventDispatcher_;
+    // 更新注册（由 Scene 维护 updateSlot_）
+    friend class Scene;
+    static constexpr uint32 INVALID_UPDATE_SLOT = 0xFFFFFFFFu;
+    uint32 updateSlot_ = INVALID_UPDATE_SLOT;
+    int updatePriority_ = 0;
+    bool updateScheduled_ = false;
+
+    bool needsUpdate() const;
+    void registerUpdate();
+
+    // 空间索引待提交列表中的位置（由 Scene 维护）
+    uint32 spatialDirtySlot_ = INVALID_UPDATE_SLOT;
+    bool spatialSubtreeDirty_ = false;  // 整棵子树已登记，提交前无需重复遍历
+    void syncSpatialIndex();
+    void markSpatialSubtreeDirty();
+
+    // 事件（按需创建）
+    UniquePtr<EventDispatcher> eventDispatcher_;
+};
+
+// ============================================================================
+// 子树标签视图 - 沿 TransformStore 的层级链接先序遍历并过滤，不分配内存
+// ============================================================================
+class NodeTagView {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Node* const*;
+        using reference = Node*;
+
+        Iterator(uint32 current, uint32 root, int tag)
+            : current_(current), root_(root), tag_(tag) { skip(); }
+
+        Node* operator*() const { return TransformStore::getInstance().getOwner(current_); }
+        Iterator& operator++() { step(); skip(); return *this; }
+        bool operator==(const Iterator& other) const { return current_ == other.current_; }
+        bool operator!=(const Iterator& other) const { return current_ != other.current_; }
+
+    private:
+        uint32 current_;
+        uint32 root_;
+        int tag_;
+
+        void step() { current_ = TransformStore::getInstance().nextInSubtree(current_, root_); }
+
+        void skip() {
+            while (current_ != TransformStore::INVALID_INDEX && (**this)->getTag() != tag_) {
+                step();
+            }
+        }
+    };
+
+    NodeTagView(uint32 root, int tag) : root_(root), tag_(tag) {}
+
+    Iterator begin() const {
+        return Iterator(TransformStore::getInstance().nextInSubtree(root_, root_), root_, tag_);
+    }
+    Iterator end() const { return Iterator(TransformStore::INVALID_INDEX, root_, tag_); }
+    bool empty() const { return begin() == end(); }
+
+private:
+    uint32 root_;
+    int tag_;
 };
 
 } // namespace easy2d
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <easy2d/core/math_types.h>
+#include <easy2d/core/name_id.h>
+#include <easy2d/scene/node.h>
+#include <string>
+#include <vector>
+
+namespace easy2d {
+
+struct SceneNodeType;
+
+// ============================================================================
+// 预制体 - 捕获一棵节点子树的快照，之后按快照快速实例化
+//
+// 捕获时记录每个节点的类型、层级、变换和驻留后的名称，类型状态（纹理、颜色、文字等）
+// 复制到一个不参与层级的模板节点中。实例化时按先序批量创建节点，直接复制变换并通过
+// 类型的 copy 回调成员式复制状态：纹理、字体等资源句柄与模板共享，名称不再驻留，
+// 也不会为实例创建事件分发器。捕获之后源子树的修改不会影响预制体。
+// ============================================================================
+class Prefab {
+public:
+    Prefab() = default;
+    Prefab(const Prefab&) = delete;
+    Prefab& operator=(const Prefab&) = delete;
+
+    /// 从现有子树捕获（root 本身也会被复制）
+    static Ptr<Prefab> create(const Node& root);
+
+    /// 从二进制场景文件捕获（见 SceneSerializer）
+    static Ptr<Prefab> createFromFile(const std::string& filepath);
+
+    /// 创建一个实例（未挂接到任何父节点）
+    Ptr<Node> instantiate() const;
+
+    /// 批量创建 count 个实例并追加到 out，变换槽位一次性预留
+    void instantiate(size_t count, std::vector<Ptr<Node>>& out) const;
+
+    size_t getNodeCount() const { return nodes_.size(); }
+
+private:
+    struct PrefabNode {
+        const SceneNodeType* type = nullptr;
+        Ptr<Node> state;            // 类型状态模板，类型没有额外状态时为空
+        uint32 parent = 0;
+        uint32 childCount = 0;
+        NameId name;
+        int tag = -1;
+        int zOrder = 0;
+        Vec2 position;
+        float rotation = 0.0f;
+        Vec2 scale{1.0f, 1.0f};
+        Vec2 anchor{0.5f, 0.5f};
+        Vec2 skew;
+        float opacity = 1.0f;
+        bool visible = true;
+        bool spatialIndexed = true;
+    };
+
+    std::vector<PrefabNode> nodes_;
+
+    void capture(const Node& root);
+    Ptr<Node> build(std::vector<Node*>& created) const;
+};
+
+} // namespace easy2d
@@ -17,7 +17,7 @@ struct RenderCommand;
 class Scene : public Node {
 public:
     Scene();
-    ~Scene() override = default;
+    ~Scene() override;
 
     // ------------------------------------------------------------------------
     // 场景属性
@@ -63,8 +63,9 @@ public:
     // ------------------------------------------------------------------------
     // 空间索引系统
     // ------------------------------------------------------------------------
-    SpatialManager& getSpatialManager() { return spatialManager_; }
-    const SpatialManager& getSpatialManager() const { return spatialManager_; }
+    // 返回前先提交待处理的边界变化，直接在管理器上查询也能看到最新状态
+    SpatialManager& getSpatialManager() { flushSpatialIndex(); return spatialManager_; }
+    const SpatialManager& getSpatialManager() const { flushSpatialIndex(); return spatialManager_; }
     
     // 启用/禁用空间索引
     void setSpatialIndexingEnabled(bool enabled) { spatialIndexingEnabled_ = enabled; }
@@ -73,12 +74,33 @@ public:
     // 节点空间索引管理（内部使用）
     void updateNodeInSpatialIndex(Node* node, const Rect& oldBounds, const Rect& newBounds);
     void removeNodeFromSpatialIndex(Node* node);
+
+    // 边界变化的节点先登记为待提交，查询前或每帧更新结束时批量写入索引；
+    // 同一节点一帧内多次变化只提交一次
+    void markSpatialDirty(Node* node);
+    void unmarkSpatialDirty(Node* node);
+    void flushSpatialIndex() const;
+    size_t getSpatialDirtyCount() const { return spatialDirty_.size() - spatialDirtyHoles_; }
     
+    // ------------------------------------------------------------------------
+    // 更新注册表（由 Node 调用）
+    // ------------------------------------------------------------------------
+    void registerUpdate(Node* node);
+    void unregisterUpdate(Node* node);
+    void markUpdateListDirty() { updateListDirty_ = true; }
+    size_t getUpdateNodeCount() const { return updateList_.size() - updateListHoles_; }
+
     // 碰撞检测查询
     std::vector<Node*> queryNodesInArea(const Rect& area) const;
     std::vector<Node*> queryNodesAtPoint(const Vec2& point) const;
+    // 结果追加到调用方的缓冲区，可跨帧复用
+    void queryNodesInArea(const Rect& area, std::vector<Node*>& results) const;
+    void queryNodesAtPoint(const Vec2& point, std::vector<Node*>& results) const;
     std::vector<std::pair<Node*, Node*>> queryCollisions() const;
 
+    /// 最近一次 queryCollisions 产生的碰撞事件（需在 SpatialManager 上启用扫描裁剪）
+    const std::vector<CollisionEvent>& getCollisionEvents() const { return spatialManager_.getCollisionEvents(); }
+
     // ------------------------------------------------------------------------
     // 静态创建方法
     // ------------------------------------------------------------------------
@@ -98,10 +120,22 @@ private:
     Ptr<Camera> defaultCamera_;
     
     bool paused_ = false;
+
+    // 需要逐帧更新的节点（按优先级排序，注销时置空，更新前统一压缩）
+    std::vector<Node*> updateList_;
+    size_t updateListHoles_ = 0;
+    bool updateListDirty_ = false;
+
+    void updateRegisteredNodes(float dt);
     
     // 空间索引系统
-    SpatialManager spatialManager_;
+    // 索引只是节点边界的缓存，const 查询前提交待处理的变化不改变场景的可见状态
+    mutable SpatialManager spatialManager_;
     bool spatialIndexingEnabled_ = true;
+
+    // 待提交的节点（移出场景时置空）
+    mutable std::vector<Node*> spatialDirty_;
+    mutable size_t spatialDirtyHoles_ = 0;
 };
 
 } // namespace easy2d
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <easy2d/scene/scene.h>
+#include <easy2d/graphics/texture.h>
+#include <easy2d/graphics/font.h>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+namespace easy2d {
+
+struct SceneSaveContext;
+struct SceneLoadContext;
+
+// ============================================================================
+// 场景数据写入器 - 节点类型的保存回调通过它写出类型数据
+// ============================================================================
+class SceneWriter {
+public:
+    template<typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "SceneWriter::write requires a trivially copyable type");
+        writeBytes(&value, sizeof(T));
+    }
+
+    void writeBytes(const void* data, size_t size);
+
+    /// 写入字符串表下标，相同字符串在文件中只存一份
+    void writeString(std::string_view str);
+
+    /// 写入纹理/字体引用（ResourceManager 的缓存 key），非托管资源写为空引用
+    void writeTexture(const Ptr<Texture>& texture);
+    void writeFont(const Ptr<FontAtlas>& font);
+
+private:
+    friend class SceneSerializer;
+    SceneWriter(SceneSaveContext& context, std::vector<uint8>& data) : context_(context), data_(data) {}
+
+    SceneSaveContext& context_;
+    std::vector<uint8>& data_;
+};
+
+// ============================================================================
+// 场景数据读取器 - 读取顺序须与写入一致；越界读取返回零值并置为无效
+// ============================================================================
+class SceneReader {
+public:
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable_v<T>, "SceneReader::read requires a trivially copyable type");
+        T value{};
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    bool readBytes(void* out, size_t size);
+
+    /// 返回的视图指向映射的文件内容，仅在加载过程中有效
+    std::string_view readString();
+
+    /// 同一文件中相同的资源引用只解析一次
+    Ptr<Texture> readTexture();
+    Ptr<FontAtlas> readFont();
+
+    size_t getRemaining() const { return static_cast<size_t>(end_ - cursor_); }
+    bool isValid() const { return valid_; }
+
+private:
+    friend class SceneSerializer;
+    SceneReader(SceneLoadContext& context, const uint8* begin, const uint8* end)
+        : context_(context), cursor_(begin), end_(end) {}
+
+    SceneLoadContext& context_;
+    const uint8* cursor_;
+    const uint8* end_;
+    bool valid_ = true;
+};
+
+// ============================================================================
+// 节点类型描述 - 创建函数与类型数据的保存/加载回调
+// ============================================================================
+struct SceneNodeType {
+    std::string name;
+    Function<Ptr<Node>()> create;
+    Function<bool(const Node&)> matches;                    // 未注册的派生类按最近注册的可匹配类型保存
+    Function<void(const Node&, SceneWriter&)> save;         // 可为空
+    Function<void(Node&, SceneReader&)> load;               // 可为空
+    Function<void(const Node&, Node&)> copy;                // 复制类型状态（Prefab 实例化），为空时以 save/load 往返代替
+};
+
+// ============================================================================
+// 二进制场景序列化
+//
+// 文件布局（小端，各段按 8 字节对齐）：
+//   文件头   魔数 "E2SC"、版本号、节点记录大小及各段偏移
+//   字符串表 uint32 偏移[stringCount + 1] + UTF-8 字符数据（类型名、节点名、资源 key、文字）
+//   节点表   nodeCount 条定长记录：父节点下标、类型、名称、标签、zOrder、变换、透明度、可见性，
+//            以及类型数据在数据区中的位置；按先序排列，父节点总在子节点之前
+//   数据区   各节点的类型数据（精灵/文字/形状参数或自定义类型写出的任意数据）
+//
+// 节点记录大小写入文件头：新版本追加字段后仍可读取旧文件（缺失字段取默认值）。
+// 加载时整个文件以只读方式映射进内存，节点按记录一次性批量创建后再挂接到层级中。
+// 内置类型：Node、Scene、Sprite、Text、ShapeNode；其他类型通过 registerNodeType 注册
+// ============================================================================
+class SceneSerializer {
+public:
+    static constexpr uint16 VERSION = 1;
+
+    /// 保存以 root 为根的整棵子树
+    static bool save(const Node& root, const std::string& filepath);
+
+    /// 加载文件中的子树，失败返回 nullptr
+    static Ptr<Node> load(const std::string& filepath);
+
+    /// 加载根节点为 Scene 的文件
+    static Ptr<Scene> loadScene(const std::string& filepath);
+
+    /// 注册自定义节点类型；name 写入文件，加载时据此创建节点，同名注册会覆盖。
+    /// copy 可选：成员式复制类型状态，供 Prefab 快速实例化
+    template<typename T>
+    static void registerNodeType(const std::string& name,
+                                 Function<void(const T&, SceneWriter&)> save,
+                                 Function<void(T&, SceneReader&)> load,
+                                 Function<void(const T&, T&)> copy = nullptr);
+
+    static void registerNodeType(std::type_index type, SceneNodeType desc);
+
+    /// 节点对应的类型描述（未注册的派生类返回最接近的已注册基类），引用长期有效
+    static const SceneNodeType& getNodeType(const Node& node);
+
+private:
+    static void copyThroughData(const Function<void(const Node&, SceneWriter&)>& save,
+                                const Function<void(Node&, SceneReader&)>& load,
+                                const Node& source, Node& target);
+};
+
+template<typename T>
+void SceneSerializer::registerNodeType(const std::string& name,
+                                       Function<void(const T&, SceneWriter&)> save,
+                                       Function<void(T&, SceneReader&)> load,
+                                       Function<void(const T&, T&)> copy) {
+    static_assert(std::is_base_of_v<Node, T>, "registerNodeType requires a Node subclass");
+
+    SceneNodeType desc;
+    desc.name = name;
+    desc.create = []() -> Ptr<Node> { return makePtr<T>(); };
+    desc.matches = [](const Node& node) { return dynamic_cast<const T*>(&node) != nullptr; };
+    if (save) {
+        desc.save = [save](const Node& node, SceneWriter& writer) {
+            save(static_cast<const T&>(node), writer);
+        };
+    }
+    if (load) {
+        desc.load = [load](Node& node, SceneReader& reader) {
+            load(static_cast<T&>(node), reader);
+        };
+    }
+    if (copy) {
+        desc.copy = [copy](const Node& source, Node& target) {
+            copy(static_cast<const T&>(source), static_cast<T&>(target));
+        };
+    }
+    registerNodeType(std::type_index(typeid(T)), std::move(desc));
+}
+
+} // namespace easy2d
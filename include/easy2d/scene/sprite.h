@@ -49,6 +49,9 @@ private:
     Color color_ = Colors::White;
     bool flipX_ = false;
     bool flipY_ = false;
+
+    Rect getLocalRect() const;
+    Rect getSourceRect() const;
 };
 
 } // namespace easy2d
@@ -34,8 +34,13 @@ public:
     void setTextColor(const Color& color);
     Color getTextColor() const { return color_; }
 
+    /// 设置显示字号：仅对 SDF 字体生效（按字号与图集字号之比缩放），
+    /// 位图字体始终按图集字号显示；<= 0 表示使用图集字号
     void setFontSize(int size);
-    int getFontSize() const { return fontSize_; }
+    int getFontSize() const;
+
+    /// 字形缩放比例（显示字号 / 图集字号）
+    float getFontScale() const;
 
     // ------------------------------------------------------------------------
     // 对齐方式
@@ -61,6 +66,7 @@ public:
     static Ptr<Text> create();
     static Ptr<Text> create(const String& text);
     static Ptr<Text> create(const String& text, Ptr<FontAtlas> font);
+    static Ptr<Text> create(const String& text, Ptr<FontAtlas> font, int fontSize);
 
     Rect getBoundingBox() const override;
 
@@ -72,13 +78,16 @@ private:
     String text_;
     Ptr<FontAtlas> font_;
     Color color_ = Colors::White;
-    int fontSize_ = 16;
+    int fontSize_ = 0;      // 0 表示使用图集字号
     Alignment alignment_ = Alignment::Left;
     
+    // 排版缓存：文字、字体、字号、对齐或图集代数变化时重建
+    mutable GlyphRun glyphRun_;
     mutable Vec2 cachedSize_ = Vec2::Zero();
-    mutable bool sizeDirty_ = true;
+    mutable bool layoutDirty_ = true;
     
     void updateCache() const;
+    Vec2 getAlignedOrigin() const;
 };
 
 } // namespace easy2d
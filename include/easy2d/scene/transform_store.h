@@ -0,0 +1,135 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <easy2d/core/math_types.h>
+#include <easy2d/core/affine2d.h>
+#include <vector>
+
+namespace easy2d {
+
+class Node;
+
+// ============================================================================
+// 变换存储 - 以 SoA 方式集中保存所有节点的变换数据
+//
+// 数组始终满足父节点下标小于子节点下标，因此每帧只需一次线性遍历即可算出全部世界变换。
+// 层级结构的变化都是增量的：释放的槽位留作空洞，新节点（此时是根）优先复用空洞；
+// 挂接到下标更大的父节点时只把该子树搬到尾部。空洞累积到一定比例后，
+// 在帧更新时按深度优先顺序整体压缩一次，使子树重新在数组中连续。
+//
+// 非线程安全：节点的创建、销毁、挂接与变换修改都会访问本单例，
+// 只能在主线程进行（不要在 JobSystem 的任务中构造或修改节点）。
+// ============================================================================
+class TransformStore {
+public:
+    static constexpr uint32 INVALID_INDEX = 0xFFFFFFFFu;
+
+    static TransformStore& getInstance();
+
+    // ------------------------------------------------------------------------
+    // 槽位管理（由 Node 构造/析构时调用）
+    // ------------------------------------------------------------------------
+    uint32 allocate(Node* owner);
+    void release(uint32 index);
+    void setParent(uint32 index, uint32 parentIndex);
+
+    /// 为即将批量创建的 count 个节点预留容量（如加载场景文件前），避免逐个扩容
+    void reserve(size_t count);
+
+    // ------------------------------------------------------------------------
+    // 变换属性
+    // ------------------------------------------------------------------------
+    const Vec2& getPosition(uint32 index) const { return positions_[index]; }
+    float getRotation(uint32 index) const { return rotations_[index]; }
+    const Vec2& getScale(uint32 index) const { return scales_[index]; }
+    const Vec2& getSkew(uint32 index) const { return skews_[index]; }
+    const Vec2& getAnchor(uint32 index) const { return anchors_[index]; }
+
+    Vec2& positionRef(uint32 index) { return positions_[index]; }
+    float& rotationRef(uint32 index) { return rotations_[index]; }
+    Vec2& scaleRef(uint32 index) { return scales_[index]; }
+    Vec2& anchorRef(uint32 index) { return anchors_[index]; }
+    Vec2& skewRef(uint32 index) { return skews_[index]; }
+
+    void setPosition(uint32 index, const Vec2& position);
+    void setRotation(uint32 index, float rotation);
+    void setScale(uint32 index, const Vec2& scale);
+    void setSkew(uint32 index, const Vec2& skew);
+    void setAnchor(uint32 index, const Vec2& anchor);
+
+    /// 通过引用修改属性后手动标记为脏
+    void markDirty(uint32 index);
+
+    // ------------------------------------------------------------------------
+    // 变换矩阵（惰性计算）
+    // ------------------------------------------------------------------------
+    const Affine2D& getLocalTransform(uint32 index);
+
+    /// 脏时沿父链惰性计算并缓存
+    Affine2D getWorldTransform(uint32 index);
+
+    /// 一次线性遍历更新所有脏的世界变换（每帧由 SceneManager 调用），
+    /// 空洞过多时先压缩（会改变节点下标）
+    void updateWorldTransforms();
+
+    // ------------------------------------------------------------------------
+    // 子树遍历（先序，不分配内存）
+    // ------------------------------------------------------------------------
+    Node* getOwner(uint32 index) const { return owners_[index]; }
+
+    /// root 子树中 index 的下一个节点，遍历结束返回 INVALID_INDEX
+    uint32 nextInSubtree(uint32 index, uint32 root) const { return advance(index, root, true); }
+
+    // ------------------------------------------------------------------------
+    // 统计
+    // ------------------------------------------------------------------------
+    size_t getSize() const { return owners_.size(); }
+    size_t getLiveCount() const { return owners_.size() - freeSlots_.size(); }
+
+private:
+    TransformStore() = default;
+    TransformStore(const TransformStore&) = delete;
+    TransformStore& operator=(const TransformStore&) = delete;
+
+    // 空洞数量达到该值且占总槽位的 1/4 以上时才压缩，摊还到每次释放为 O(1)
+    static constexpr size_t COMPACT_MIN_TOMBSTONES = 1024;
+
+    // SoA 数组（同一下标对应同一节点）
+    std::vector<Node*> owners_;         // 空洞为 nullptr
+    std::vector<uint32> parents_;
+    std::vector<uint32> firstChildren_;
+    std::vector<uint32> lastChildren_;
+    std::vector<uint32> nextSiblings_;
+    std::vector<uint32> prevSiblings_;
+    std::vector<Vec2> positions_;
+    std::vector<float> rotations_;
+    std::vector<Vec2> scales_;
+    std::vector<Vec2> skews_;
+    std::vector<Vec2> anchors_;
+    std::vector<Affine2D> locals_;
+    std::vector<Affine2D> worlds_;
+    std::vector<uint8_t> localDirty_;
+    std::vector<uint8_t> worldDirty_;   // 不变式：节点为脏时其整棵子树均为脏
+
+    std::vector<uint32> freeSlots_;     // 空洞
+    std::vector<uint32> scratch_;       // 搬移/压缩时复用的临时下标
+
+    void link(uint32 index, uint32 parentIndex);
+    void unlink(uint32 index);
+    uint32 advance(uint32 index, uint32 root, bool descend) const;
+    void markSubtreeDirty(uint32 index);
+    void computeWorld(uint32 index);
+
+    void relocateSubtree(uint32 root);
+    void moveSlot(uint32 from);
+    void clearSlot(uint32 index);
+    void compact();
+    bool needsCompaction() const {
+        return freeSlots_.size() >= COMPACT_MIN_TOMBSTONES && freeSlots_.size() * 4 >= owners_.size();
+    }
+
+    template <typename T>
+    static void permute(std::vector<T>& values, const std::vector<uint32>& order);
+};
+
+} // namespace easy2d
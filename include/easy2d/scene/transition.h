@@ -20,7 +20,7 @@ enum class TransitionDirection {
 // ============================================================================
 // 过渡效果基类
 // ============================================================================
-class Transition : public std::enable_shared_from_this<Transition> {
+class Transition : public EnableSharedFromThis<Transition> {
 public:
     using FinishCallback = std::function<void()>;
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <easy2d/spatial/spatial_index.h>
+#include <unordered_map>
+
+namespace easy2d {
+
+// ============================================================================
+// 动态 AABB 树 - 叶节点保存外扩后的包围盒，内部节点为子节点包围盒的并集
+//
+// 不依赖世界边界，适合对象尺寸差异大或活动范围不受限的场景。
+// 插入时按表面积启发式（2D 中为周长）选择兄弟节点，回溯时按高度做树旋转保持平衡；
+// 对象移动后仍在外扩包围盒内时只更新真实边界，否则移出后重新插入，
+// 外扩量沿位移方向额外预测一段。祖先的包围盒与高度都不变时回溯提前结束。
+// 节点存放在扁平数组中，通过下标链接，释放的节点经空闲链表复用。
+// ============================================================================
+class AABBTree : public ISpatialIndex {
+public:
+    /// fatMargin 为叶节点包围盒的外扩量；displacementMultiplier 为位移预测系数
+    explicit AABBTree(float fatMargin = 8.0f, float displacementMultiplier = 2.0f);
+    ~AABBTree() override = default;
+
+    void insert(Node* node, const Rect& bounds) override;
+    void remove(Node* node) override;
+    void update(Node* node, const Rect& newBounds) override;
+
+    using ISpatialIndex::query;
+    void query(const Rect& area, std::vector<Node*>& results) const override;
+    void query(const Vec2& point, std::vector<Node*>& results) const override;
+    bool visit(const Rect& area, SpatialVisitor visitor) const override;
+    bool visit(const Vec2& point, SpatialVisitor visitor) const override;
+    void castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const override;
+    void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const override;
+    void collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                        std::vector<SpatialNeighbor>& results) const override;
+    std::vector<std::pair<Node*, Node*>> queryCollisions() const override;
+    void forEachObject(SpatialObjectVisitor visitor) const override;
+
+    void clear() override;
+    size_t size() const override;
+    bool empty() const override;
+
+    void rebuild() override;
+
+    /// 树高（空树为 0）
+    int getHeight() const;
+
+    float getFatMargin() const { return fatMargin_; }
+
+private:
+    static constexpr int32 INVALID = -1;
+
+    // 平衡树高度不超过 1.44 log2(n)，深度优先遍历的栈深度远小于该值
+    static constexpr int MAX_STACK = 256;
+
+    struct TreeNode {
+        Rect fat;                       // 叶节点为外扩包围盒，内部节点为子节点并集
+        Rect bounds;                    // 叶节点的真实边界
+        Node* object = nullptr;
+        int32 parent = INVALID;         // 空闲节点中表示下一个空闲节点
+        int32 child1 = INVALID;
+        int32 child2 = INVALID;
+        int32 height = 0;               // 叶节点为 0，空闲节点为 -1
+
+        bool isLeaf() const { return child1 == INVALID; }
+    };
+
+    int32 allocateNode();
+    void freeNode(int32 index);
+    Rect fatten(const Rect& bounds) const;
+
+    void insertLeaf(int32 leaf);
+    void removeLeaf(int32 leaf);
+    void refitAncestors(int32 index);
+    int32 balance(int32 index);
+
+    template <typename Visitor>
+    bool queryArea(const Rect& area, Visitor& visitor) const;
+    template <typename Visitor>
+    bool queryPoint(const Vec2& point, Visitor& visitor) const;
+
+    std::vector<TreeNode> nodes_;
+    int32 root_ = INVALID;
+    int32 freeList_ = INVALID;
+
+    // 对象到叶节点的反向索引
+    std::unordered_map<Node*, int32> leaves_;
+
+    float fatMargin_;
+    float displacementMultiplier_;
+};
+
+}
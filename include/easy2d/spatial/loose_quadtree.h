@@ -0,0 +1,113 @@
+#pragma once
+
+#include <easy2d/spatial/spatial_index.h>
+#include <unordered_map>
+
+namespace easy2d {
+
+// ============================================================================
+// 松散四叉树 - 树节点与对象分别存放在两个扁平数组中，以下标相互链接
+//
+// 每个树节点的松散边界是紧致边界按 looseness 倍放大（looseness = 1.5 时四周各扩展四分之一格），
+// 对象按中心点选择子象限，只要完整落在该子节点的松散边界内就继续下沉，
+// 因此跨越分割线的小对象不会滞留在根节点。四个兄弟节点在数组中连续存放，
+// 被回收的节点块与对象槽位通过空闲链表复用；最大深度由世界尺寸和最小格子尺寸推算。
+// 链表改动累计到对象数量后按深度优先顺序重排对象槽位，让查询保持顺序访问内存。
+// ============================================================================
+class LooseQuadTree : public ISpatialIndex {
+public:
+    static constexpr int MAX_DEPTH_LIMIT = 16;
+
+    /// looseness 取值 [1, 4]（1 退化为普通四叉树）；minCellSize 决定最大深度；nodeCapacity 为叶节点分裂阈值
+    explicit LooseQuadTree(const Rect& worldBounds, float looseness = 1.5f,
+                           float minCellSize = 32.0f, int nodeCapacity = 16);
+    ~LooseQuadTree() override = default;
+
+    void insert(Node* node, const Rect& bounds) override;
+    void remove(Node* node) override;
+    void update(Node* node, const Rect& newBounds) override;
+
+    using ISpatialIndex::query;
+    void query(const Rect& area, std::vector<Node*>& results) const override;
+    void query(const Vec2& point, std::vector<Node*>& results) const override;
+    bool visit(const Rect& area, SpatialVisitor visitor) const override;
+    bool visit(const Vec2& point, SpatialVisitor visitor) const override;
+    void castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const override;
+    void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const override;
+    void collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                        std::vector<SpatialNeighbor>& results) const override;
+    std::vector<std::pair<Node*, Node*>> queryCollisions() const override;
+    void forEachObject(SpatialObjectVisitor visitor) const override;
+
+    void clear() override;
+    size_t size() const override;
+    bool empty() const override;
+
+    void rebuild() override;
+
+    float getLooseness() const { return looseness_; }
+    int getMaxDepth() const { return maxDepth_; }
+    size_t getCellCount() const { return cells_.size() - freeCellCount_; }
+
+private:
+    static constexpr int32 INVALID = -1;
+
+    struct Cell {
+        Rect loose;                     // 松散边界（查询裁剪用）
+        Vec2 center;                    // 紧致边界中心（选择子象限）
+        Vec2 half;                      // 紧致边界半尺寸
+        int32 parent = INVALID;
+        int32 firstChild = INVALID;     // 四个子节点连续存放；空闲块中表示下一个空闲块
+        int32 firstElement = INVALID;
+        int32 count = 0;
+        int32 depth = 0;
+        bool mergePending = false;
+    };
+
+    struct Element {
+        Node* object = nullptr;         // 为空表示槽位空闲
+        Rect bounds;
+        int32 cell = INVALID;
+        int32 prev = INVALID;
+        int32 next = INVALID;           // 空闲槽位中表示下一个空闲槽位
+    };
+
+    void resetRoot();
+    Cell makeChild(const Cell& parent, int32 parentIndex, int quadrant) const;
+    static int quadrantFor(const Cell& cell, const Rect& bounds);
+    int32 findCell(int32 start, const Rect& bounds) const;
+
+    int32 allocateElement();
+    int32 allocateChildren();
+    void linkElement(int32 element, int32 cell);
+    void unlinkElement(int32 element);
+    void split(int32 cell);
+    void maintain();
+    void mergePending();
+    void compact();
+
+    template <typename Visitor>
+    bool queryArea(const Rect& area, Visitor& visitor) const;
+    template <typename Visitor>
+    bool queryPoint(const Vec2& point, Visitor& visitor) const;
+
+    std::vector<Cell> cells_;
+    std::vector<Element> elements_;
+    int32 freeCellBlock_ = INVALID;
+    int32 freeElement_ = INVALID;
+    size_t freeCellCount_ = 0;
+    size_t relinkCount_ = 0;        // 上次重排后对象链表的改动次数
+
+    // 对象到元素槽位的反向索引
+    std::unordered_map<Node*, int32> lookup_;
+
+    // 子节点可能已全部清空、等待合并的树节点（在下一次插入/更新时处理）
+    std::vector<int32> pendingMerges_;
+
+    Rect worldBounds_;
+    float looseness_;
+    int maxDepth_;
+    int nodeCapacity_;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include <easy2d/spatial/spatial_index.h>
 #include <array>
+#include <unordered_map>
 
 namespace easy2d {
 
@@ -9,14 +10,18 @@ class QuadTree : public ISpatialIndex {
 public:
     static constexpr int MAX_OBJECTS = 10;
     static constexpr int MAX_LEVELS = 5;
+    // 满树的节点总数 (4^(MAX_LEVELS+1) - 1) / 3
+    static constexpr int MAX_NODE_COUNT = ((1 << (2 * (MAX_LEVELS + 1))) - 1) / 3;
 
     struct QuadTreeNode {
         Rect bounds;
         int level;
+        QuadTreeNode* parent;
+        bool mergePending = false;
         std::vector<std::pair<Node*, Rect>> objects;
         std::array<std::unique_ptr<QuadTreeNode>, 4> children;
 
-        QuadTreeNode(const Rect& bounds, int level);
+        QuadTreeNode(const Rect& bounds, int level, QuadTreeNode* parent = nullptr);
         bool contains(const Rect& rect) const;
         bool intersects(const Rect& rect) const;
     };
@@ -28,9 +33,17 @@ public:
     void remove(Node* node) override;
     void update(Node* node, const Rect& newBounds) override;
 
-    std::vector<Node*> query(const Rect& area) const override;
-    std::vector<Node*> query(const Vec2& point) const override;
+    using ISpatialIndex::query;
+    void query(const Rect& area, std::vector<Node*>& results) const override;
+    void query(const Vec2& point, std::vector<Node*>& results) const override;
+    bool visit(const Rect& area, SpatialVisitor visitor) const override;
+    bool visit(const Vec2& point, SpatialVisitor visitor) const override;
+    void castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const override;
+    void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const override;
+    void collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                        std::vector<SpatialNeighbor>& results) const override;
     std::vector<std::pair<Node*, Node*>> queryCollisions() const override;
+    void forEachObject(SpatialObjectVisitor visitor) const override;
 
     void clear() override;
     size_t size() const override;
@@ -39,16 +52,35 @@ public:
     void rebuild() override;
 
 private:
+    // 对象所在的树节点及其在 objects 中的下标
+    struct Location {
+        QuadTreeNode* cell;
+        size_t slot;
+    };
+
     void split(QuadTreeNode* node);
     void insertIntoNode(QuadTreeNode* node, Node* object, const Rect& bounds);
-    void queryNode(const QuadTreeNode* node, const Rect& area, std::vector<Node*>& results) const;
-    void queryNode(const QuadTreeNode* node, const Vec2& point, std::vector<Node*>& results) const;
+    void eraseFromCell(QuadTreeNode* cell, size_t slot);
+    void mergePending();
+    static int childIndexFor(const QuadTreeNode* node, const Rect& bounds);
+    template <typename Visitor>
+    static bool queryNode(const QuadTreeNode* node, const Rect& area, Visitor& visitor);
+    template <typename Visitor>
+    static bool queryNode(const QuadTreeNode* node, const Vec2& point, Visitor& visitor);
+    static bool castNode(const QuadTreeNode* node, const SpatialRay& ray, const Rect& sweep, float& maxT,
+                         SpatialRayVisitor& visitor);
+    static void queryCircleNode(const QuadTreeNode* node, const Vec2& center, float radius, std::vector<Node*>& results);
     void collectCollisions(const QuadTreeNode* node, std::vector<std::pair<Node*, Node*>>& collisions) const;
-    bool removeFromNode(QuadTreeNode* node, Node* object);
 
     std::unique_ptr<QuadTreeNode> root_;
     Rect worldBounds_;
     size_t objectCount_ = 0;
+
+    // 反向索引：删除与更新直接定位，无需从根节点搜索
+    std::unordered_map<Node*, Location> locations_;
+
+    // 子节点可能已全部清空、等待合并的树节点（在下一次插入/更新时处理）
+    std::vector<QuadTreeNode*> pendingMerges_;
 };
 
 }
@@ -1,20 +1,20 @@
 #pragma once
 
 #include <easy2d/spatial/spatial_index.h>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace easy2d {
 
+// ============================================================================
+// 空间哈希 - 均匀网格，只为有对象的格子分配存储
+//
+// 格子坐标打包为 64 位键，存放在线性探测的开放寻址表中；每个格子记录一条链表头，
+// 链表元素来自同一个连续的元素池（空闲链表复用）。对象信息存放在稠密数组中，
+// 删除时与末尾对象交换；Node* 到数组下标的映射同样是开放寻址表。
+// 矩形查询通过对象上的查询戳去重，因此同一索引上的查询不能在多个线程中并发执行。
+// ============================================================================
 class SpatialHash : public ISpatialIndex {
 public:
-    using CellKey = std::pair<int64_t, int64_t>;
-    
-    struct CellKeyHash {
-        size_t operator()(const CellKey& key) const {
-            return std::hash<int64_t>()(key.first) ^ (std::hash<int64_t>()(key.second) << 1);
-        }
-    };
+    using CellKey = uint64;
 
     explicit SpatialHash(float cellSize = 64.0f);
     ~SpatialHash() override = default;
@@ -23,9 +23,17 @@ public:
     void remove(Node* node) override;
     void update(Node* node, const Rect& newBounds) override;
 
-    std::vector<Node*> query(const Rect& area) const override;
-    std::vector<Node*> query(const Vec2& point) const override;
+    using ISpatialIndex::query;
+    void query(const Rect& area, std::vector<Node*>& results) const override;
+    void query(const Vec2& point, std::vector<Node*>& results) const override;
+    bool visit(const Rect& area, SpatialVisitor visitor) const override;
+    bool visit(const Vec2& point, SpatialVisitor visitor) const override;
+    void castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const override;
+    void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const override;
+    void collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                        std::vector<SpatialNeighbor>& results) const override;
     std::vector<std::pair<Node*, Node*>> queryCollisions() const override;
+    void forEachObject(SpatialObjectVisitor visitor) const override;
 
     void clear() override;
     size_t size() const override;
@@ -37,15 +45,74 @@ public:
     float getCellSize() const { return cellSize_; }
 
 private:
-    CellKey getCellKey(float x, float y) const;
-    void getCellsForRect(const Rect& rect, std::vector<CellKey>& cells) const;
-    void insertIntoCells(Node* node, const Rect& bounds);
-    void removeFromCells(Node* node, const Rect& bounds);
+    static constexpr int32 INVALID = -1;
+
+    struct CellRange {
+        int32 minX, minY, maxX, maxY;
+
+        bool operator==(const CellRange& other) const {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
+    };
+
+    struct Object {
+        Node* node;
+        Rect bounds;
+        CellRange cells;
+        mutable uint32 stamp;           // 最近一次访问它的查询
+    };
+
+    struct CellEntry {
+        uint32 object;                  // objects_ 下标；空闲时为下一个空闲元素
+        int32 next;
+    };
+
+    struct CellSlot {
+        CellKey key = 0;
+        int32 head = INVALID;
+        uint32 count = 0;               // 0 表示空槽
+    };
+
+    static CellKey packKey(int32 x, int32 y);
+    static void unpackKey(CellKey key, int32& x, int32& y);
+    int32 toCell(float value) const;
+    CellRange getCellRange(const Rect& rect) const;
+
+    // 格子表
+    const CellSlot* findCell(CellKey key) const;
+    CellSlot& acquireCell(CellKey key);
+    void eraseCellSlot(size_t slot);
+    void growCells();
+    void addToCells(uint32 object, const CellRange& range);
+    void removeFromCells(uint32 object, const CellRange& range);
+    void relabelInCells(uint32 from, uint32 to, const CellRange& range);
+
+    // 对象表
+    size_t findObjectSlot(Node* node) const;
+    void insertObjectSlot(uint32 object);
+    void eraseObjectSlot(size_t slot);
+    void growObjects();
+
+    uint32 nextStamp() const;
+
+    // 遍历范围内格子中的对象（按查询戳去重），visitor(const Object&) 返回 false 时停止
+    template <typename Visitor>
+    bool forEachCandidate(const CellRange& range, Visitor&& visitor) const;
+    template <typename Visitor>
+    bool queryArea(const Rect& area, Visitor& visitor) const;
+    template <typename Visitor>
+    bool queryPoint(const Vec2& point, Visitor& visitor) const;
 
     float cellSize_;
-    std::unordered_map<CellKey, std::unordered_set<Node*>, CellKeyHash> grid_;
-    std::unordered_map<Node*, Rect> objectBounds_;
-    size_t objectCount_ = 0;
+    float inverseCellSize_;
+
+    std::vector<Object> objects_;
+    std::vector<uint32> objectSlots_;   // 对象下标 + 1，0 表示空槽
+    std::vector<CellSlot> cellSlots_;
+    size_t cellCount_ = 0;
+    std::vector<CellEntry> entries_;
+    int32 freeEntry_ = INVALID;
+    mutable uint32 queryStamp_ = 0;
 };
 
 }
@@ -3,7 +3,11 @@
 #include <easy2d/core/types.h>
 #include <easy2d/core/math_types.h>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <type_traits>
 
 namespace easy2d {
 
@@ -12,7 +16,9 @@ class Node;
 enum class SpatialStrategy {
     Auto,
     QuadTree,
-    SpatialHash
+    SpatialHash,
+    LooseQuadTree,
+    AABBTree
 };
 
 struct SpatialQueryResult {
@@ -20,6 +26,204 @@ struct SpatialQueryResult {
     Rect bounds;
 };
 
+// ============================================================================
+// 查询回调 - 对可调用对象的非持有引用，构造与调用都不分配内存
+// 只在一次查询调用期间有效，不能保存
+// ============================================================================
+template <typename Signature>
+class SpatialCallback;
+
+template <typename R, typename... Args>
+class SpatialCallback<R(Args...)> {
+public:
+    template <typename F,
+              typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SpatialCallback>>>
+    SpatialCallback(F&& callable)
+        : callable_(const_cast<void*>(static_cast<const void*>(&callable)))
+        , invoke_([](void* callable, Args... args) -> R {
+              return (*static_cast<std::remove_reference_t<F>*>(callable))(args...);
+          }) {}
+
+    R operator()(Args... args) const { return invoke_(callable_, args...); }
+
+private:
+    void* callable_;
+    R (*invoke_)(void*, Args...);
+};
+
+// 区域查询访问器：返回 false 时提前结束查询
+using SpatialVisitor = SpatialCallback<bool(Node*)>;
+
+// 射线类查询访问器：参数为对象与进入参数 t，返回新的最大参数（返回 t 表示只关心更近的对象），
+// 返回负数时结束查询
+using SpatialRayVisitor = SpatialCallback<float(Node*, float)>;
+
+// 最近邻查询的过滤器：返回 true 表示接受该对象
+using SpatialFilter = SpatialCallback<bool(Node*)>;
+
+// 遍历全部对象：参数为对象与索引中保存的边界
+using SpatialObjectVisitor = SpatialCallback<void(Node*, const Rect&)>;
+
+// ============================================================================
+// 参数化射线 origin + t * delta；extent 为沿射线扫过的盒子的半尺寸（细射线为 0），
+// 相交测试时目标矩形各向外扩 extent
+// ============================================================================
+struct SpatialRay {
+    Vec2 origin;
+    Vec2 delta;
+    Vec2 extent;
+    Vec2 inverseDelta;          // 分量为 0 时不使用
+
+    SpatialRay(const Vec2& origin, const Vec2& delta, const Vec2& extent = Vec2::Zero())
+        : origin(origin), delta(delta), extent(extent)
+        , inverseDelta(delta.x != 0.0f ? 1.0f / delta.x : 0.0f, delta.y != 0.0f ? 1.0f / delta.y : 0.0f) {}
+
+    /// 分轴（slab）测试：与 rect 在 [0, maxT] 内相交时写入进入参数 tEnter（起点在内部时为 0）
+    bool intersects(const Rect& rect, float maxT, float& tEnter) const {
+        float tMin = 0.0f;
+        float tMax = maxT;
+        if (!clipAxis(origin.x, delta.x, inverseDelta.x, rect.left() - extent.x, rect.right() + extent.x, tMin, tMax) ||
+            !clipAxis(origin.y, delta.y, inverseDelta.y, rect.top() - extent.y, rect.bottom() + extent.y, tMin, tMax)) {
+            return false;
+        }
+        tEnter = tMin;
+        return true;
+    }
+
+    /// [0, maxT] 段扫过区域的包围盒，用于在 slab 测试前廉价地排除对象
+    Rect bounds(float maxT) const {
+        Vec2 end = origin + delta * maxT;
+        float left = std::min(origin.x, end.x) - extent.x;
+        float top = std::min(origin.y, end.y) - extent.y;
+        return Rect(left, top, std::abs(end.x - origin.x) + extent.x * 2.0f, std::abs(end.y - origin.y) + extent.y * 2.0f);
+    }
+
+private:
+    static bool clipAxis(float start, float d, float inverse, float low, float high, float& tMin, float& tMax) {
+        if (d == 0.0f) {
+            return start >= low && start <= high;
+        }
+        float t1 = (low - start) * inverse;
+        float t2 = (high - start) * inverse;
+        if (t1 > t2) {
+            std::swap(t1, t2);
+        }
+        tMin = std::max(tMin, t1);
+        tMax = std::min(tMax, t2);
+        return tMin <= tMax;
+    }
+};
+
+/// 圆与矩形是否相交（含边界）
+inline bool circleIntersects(const Rect& rect, const Vec2& center, float radius) {
+    float dx = center.x - std::clamp(center.x, rect.left(), rect.right());
+    float dy = center.y - std::clamp(center.y, rect.top(), rect.bottom());
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+struct RaycastHit {
+    Node* node = nullptr;
+    float fraction = 0.0f;      // 沿位移的比例 [0, 1]
+    float distance = 0.0f;      // 沿方向的距离
+    Vec2 point;                 // 射线的命中点；扫掠查询中为接触时盒子的中心
+};
+
+/// 点到矩形的距离平方（点在矩形内为 0）
+inline float distanceSquared(const Rect& rect, const Vec2& point) {
+    float dx = std::max(std::max(rect.left() - point.x, point.x - rect.right()), 0.0f);
+    float dy = std::max(std::max(rect.top() - point.y, point.y - rect.bottom()), 0.0f);
+    return dx * dx + dy * dy;
+}
+
+struct SpatialNeighbor {
+    Node* node = nullptr;
+    float distance = 0.0f;      // 查询点到包围盒的距离
+};
+
+// ============================================================================
+// 最近邻结果集 - 在 results 尾部维护容量为 k 的最大堆（按距离平方），
+// 堆满后堆顶即当前第 k 近的距离，用作遍历的剪枝半径；finish 后按距离升序排列。
+// 容量不限（半径查询）时只追加，最后统一排序
+// ============================================================================
+class NearestCollector {
+public:
+    static constexpr size_t SMALL_K = 16;
+
+    NearestCollector(std::vector<SpatialNeighbor>& results, size_t k, float maxDistance)
+        : results_(results), first_(results.size())
+        , bounded_(k != std::numeric_limits<size_t>::max())
+        , k_(k)
+        , bound_(maxDistance * maxDistance) {}
+
+    /// 剪枝半径的平方：距离更远的节点、格子或对象无需访问
+    float boundSquared() const { return bound_; }
+
+    /// 距离平方为 d 的对象能否进入结果集（与第 k 近等距时替换也无妨）
+    bool wants(float d) const { return d <= bound_; }
+
+    void offer(Node* node, float d) {
+        if (!bounded_) {
+            results_.push_back(SpatialNeighbor{node, d});
+            return;
+        }
+        if (k_ <= SMALL_K) {
+            // k 较小时保持升序数组，插入只需移动少量元素
+            if (count_ < k_) {
+                results_.push_back(SpatialNeighbor{node, d});
+                ++count_;
+            }
+            size_t i = first_ + count_ - 1;
+            while (i > first_ && results_[i - 1].distance > d) {
+                results_[i] = results_[i - 1];
+                --i;
+            }
+            results_[i] = SpatialNeighbor{node, d};
+            if (count_ == k_) {
+                bound_ = results_.back().distance;
+            }
+            return;
+        }
+        if (count_ == k_) {
+            std::pop_heap(begin(), results_.end(), farther);
+            results_.back() = SpatialNeighbor{node, d};
+        } else {
+            results_.push_back(SpatialNeighbor{node, d});
+            ++count_;
+        }
+        std::push_heap(begin(), results_.end(), farther);
+        if (count_ == k_) {
+            bound_ = results_[first_].distance;
+        }
+    }
+
+    void finish() {
+        if (!bounded_) {
+            std::sort(begin(), results_.end(), farther);
+        } else if (k_ > SMALL_K) {
+            std::sort_heap(begin(), results_.end(), farther);
+        }
+        for (auto it = begin(); it != results_.end(); ++it) {
+            it->distance = std::sqrt(it->distance);
+        }
+    }
+
+private:
+    static bool farther(const SpatialNeighbor& a, const SpatialNeighbor& b) {
+        return a.distance < b.distance;
+    }
+
+    std::vector<SpatialNeighbor>::iterator begin() {
+        return results_.begin() + static_cast<std::ptrdiff_t>(first_);
+    }
+
+    std::vector<SpatialNeighbor>& results_;
+    size_t first_;
+    bool bounded_;
+    size_t k_;
+    size_t count_ = 0;
+    float bound_;
+};
+
 class ISpatialIndex {
 public:
     virtual ~ISpatialIndex() = default;
@@ -28,10 +232,63 @@ public:
     virtual void remove(Node* node) = 0;
     virtual void update(Node* node, const Rect& newBounds) = 0;
 
-    virtual std::vector<Node*> query(const Rect& area) const = 0;
-    virtual std::vector<Node*> query(const Vec2& point) const = 0;
+    // 结果追加到调用方的缓冲区（不会先清空），缓冲区跨查询复用时不再分配
+    virtual void query(const Rect& area, std::vector<Node*>& results) const = 0;
+    virtual void query(const Vec2& point, std::vector<Node*>& results) const = 0;
+
+    // 逐个交给访问器，访问器返回 false 时停止；返回是否遍历了全部结果
+    virtual bool visit(const Rect& area, SpatialVisitor visitor) const = 0;
+    virtual bool visit(const Vec2& point, SpatialVisitor visitor) const = 0;
+
+    std::vector<Node*> query(const Rect& area) const {
+        std::vector<Node*> results;
+        query(area, results);
+        return results;
+    }
+    std::vector<Node*> query(const Vec2& point) const {
+        std::vector<Node*> results;
+        query(point, results);
+        return results;
+    }
+
+    // 射线类查询的底层遍历：对外扩 ray.extent 后与 [0, maxT] 段相交的对象调用 visitor，
+    // 树结构按由近及远的顺序访问子节点，网格沿射线逐格行进，都会随 visitor 返回的参数收紧裁剪
+    virtual void castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const = 0;
+
+    // 与圆相交的对象，结果追加到缓冲区
+    virtual void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const = 0;
+
+    /// 最近的命中；direction 不必归一化
+    bool raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
+
+    /// 全部命中，按距离由近及远追加到 hits
+    void raycastAll(const Vec2& origin, const Vec2& direction, float maxDistance,
+                    std::vector<RaycastHit>& hits) const;
+
+    /// 与线段 start-end 相交的对象（不排序）
+    void querySegment(const Vec2& start, const Vec2& end, std::vector<Node*>& results) const;
+
+    /// box 沿 displacement 移动时接触到的对象，按接触先后追加到 hits
+    void querySwept(const Rect& box, const Vec2& displacement, std::vector<RaycastHit>& hits) const;
+
+    // 最近邻查询的底层遍历：把距离不超过 maxDistance、通过 filter 的最近 k 个对象
+    // 按距离升序追加到 results
+    virtual void collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                                std::vector<SpatialNeighbor>& results) const = 0;
+
+    /// 离 point 最近的 k 个对象（距离按包围盒计算），按距离升序追加到 results
+    void queryNearest(const Vec2& point, size_t k, std::vector<SpatialNeighbor>& results) const;
+    void queryNearest(const Vec2& point, size_t k, SpatialFilter filter, std::vector<SpatialNeighbor>& results) const;
+
+    /// 距离 point 不超过 radius 的全部对象，按距离升序追加到 results
+    void queryRadius(const Vec2& point, float radius, std::vector<SpatialNeighbor>& results) const;
+    void queryRadius(const Vec2& point, float radius, SpatialFilter filter, std::vector<SpatialNeighbor>& results) const;
+
     virtual std::vector<std::pair<Node*, Node*>> queryCollisions() const = 0;
 
+    // 按任意顺序访问全部对象及其登记时的边界（迁移索引时使用，不读取节点当前状态）
+    virtual void forEachObject(SpatialObjectVisitor visitor) const = 0;
+
     virtual void clear() = 0;
     virtual size_t size() const = 0;
     virtual bool empty() const = 0;
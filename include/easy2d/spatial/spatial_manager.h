@@ -1,8 +1,10 @@
 #pragma once
 
 #include <easy2d/spatial/spatial_index.h>
+#include <easy2d/spatial/sweep_and_prune.h>
 #include <memory>
 #include <functional>
+#include <unordered_set>
 
 namespace easy2d {
 
@@ -31,6 +33,42 @@ public:
     void query(const Rect& area, const QueryCallback& callback) const;
     void query(const Vec2& point, const QueryCallback& callback) const;
 
+    /// 结果追加到调用方的缓冲区（不会先清空），每帧复用同一缓冲区即可避免分配
+    void query(const Rect& area, std::vector<Node*>& results) const;
+    void query(const Vec2& point, std::vector<Node*>& results) const;
+
+    /// 逐个交给访问器，访问器返回 false 时提前结束；返回是否遍历了全部结果
+    bool visit(const Rect& area, SpatialVisitor visitor) const;
+    bool visit(const Vec2& point, SpatialVisitor visitor) const;
+
+    /// 射线类查询（见 ISpatialIndex）：最近命中、按距离排序的全部命中、线段、圆与扫掠盒
+    bool raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const;
+    void raycastAll(const Vec2& origin, const Vec2& direction, float maxDistance,
+                    std::vector<RaycastHit>& hits) const;
+    void querySegment(const Vec2& start, const Vec2& end, std::vector<Node*>& results) const;
+    void queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const;
+    void querySwept(const Rect& box, const Vec2& displacement, std::vector<RaycastHit>& hits) const;
+
+    /// 最近的 k 个对象 / 半径内的全部对象，按距离升序追加到 results（见 ISpatialIndex）
+    void queryNearest(const Vec2& point, size_t k, std::vector<SpatialNeighbor>& results) const;
+    void queryNearest(const Vec2& point, size_t k, SpatialFilter filter, std::vector<SpatialNeighbor>& results) const;
+    void queryRadius(const Vec2& point, float radius, std::vector<SpatialNeighbor>& results) const;
+    void queryRadius(const Vec2& point, float radius, SpatialFilter filter, std::vector<SpatialNeighbor>& results) const;
+
+    /// 查询统计，默认关闭；开启后每次查询记录次数与耗时
+    void setInstrumentationEnabled(bool enabled) { instrumentationEnabled_ = enabled; }
+    bool isInstrumentationEnabled() const { return instrumentationEnabled_; }
+    size_t getQueryCount() const { return queryCount_; }
+    double getTotalQueryTime() const;   // 毫秒
+    void resetQueryStats();
+
+    /// 启用后 queryCollisions 由常驻的扫描裁剪宽相位回答，并生成 Begin/Persist/End 事件
+    void setSweepAndPruneEnabled(bool enabled);
+    bool isSweepAndPruneEnabled() const { return sweepAndPrune_ != nullptr; }
+
+    /// 最近一次 queryCollisions 相对上一次的变化（需启用扫描裁剪）
+    const std::vector<CollisionEvent>& getCollisionEvents() const;
+
     void clear();
     size_t size() const;
     bool empty() const;
@@ -43,19 +81,40 @@ public:
 
     static std::unique_ptr<ISpatialIndex> createIndex(SpatialStrategy strategy, const Rect& bounds);
 
+    /// Auto 模式下超过该尺寸的对象视为大对象
+    static constexpr float LARGE_OBJECT_EXTENT = 512.0f;
+
+    /// Auto 模式下特殊对象全部消失后，至少再经过这么多次增删改（且不少于对象数）才退出 AABB 树
+    static constexpr size_t AUTO_TREE_COOLDOWN = 256;
+
 private:
-    void selectOptimalStrategy();
+    void selectOptimalStrategy(size_t objectCount = 0);
+    bool isAutoOutlier(const Rect& bounds) const;
+    bool trackAutoOutlier(Node* node, const Rect& bounds);
+    void settleAutoStrategy();
+    void recountAutoOutliers();
+    void rebuildIndex();
+    void migrateFrom(ISpatialIndex& oldIndex);
 
     SpatialStrategy currentStrategy_ = SpatialStrategy::Auto;
     SpatialStrategy activeStrategy_ = SpatialStrategy::QuadTree;
     std::unique_ptr<ISpatialIndex> index_;
+    std::unique_ptr<SweepAndPrune> sweepAndPrune_;
     Rect worldBounds_;
     
     size_t quadTreeThreshold_ = 1000;
     size_t hashThreshold_ = 5000;
+
+    // Auto：存在世界范围之外或超大的对象（特殊对象）时改用 AABB 树。
+    // 特殊对象全部消失后经过一段冷却期再回到按数量选择的策略，避免对象在边界附近往返时反复重建；
+    // setWorldBounds / optimize / rebuild / clear 会立即重新判断
+    bool preferTree_ = false;
+    std::unordered_set<Node*> autoOutliers_;
+    size_t calmUpdates_ = 0;      // 使用 AABB 树且没有特殊对象以来的增删改次数
     
+    bool instrumentationEnabled_ = false;
     mutable size_t queryCount_ = 0;
-    mutable size_t totalQueryTime_ = 0;
+    mutable uint64 totalQueryTime_ = 0;     // 纳秒
 };
 
 }
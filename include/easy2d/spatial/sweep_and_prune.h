@@ -0,0 +1,95 @@
+#pragma once
+
+#include <easy2d/core/types.h>
+#include <easy2d/core/math_types.h>
+#include <unordered_map>
+#include <vector>
+
+namespace easy2d {
+
+class Node;
+
+enum class CollisionPhase {
+    Begin,      // 本次开始相交
+    Persist,    // 上次和本次都相交
+    End         // 上次相交、本次分离
+};
+
+struct CollisionEvent {
+    Node* first;
+    Node* second;
+    CollisionPhase phase;
+};
+
+// ============================================================================
+// 扫描裁剪（Sweep and Prune）宽相位 - 利用帧间连续性的碰撞对检测
+//
+// 所有包围盒按一个轴上的最小坐标排序并在帧间保持；每次 updatePairs 时先用插入排序
+// 修正顺序（运动连续时接近 O(n)），再沿该轴扫描生成相交对。排序轴取对象中心分布
+// 更分散的一轴。相交对以排序后的 64 位键缓存，与上一次的结果归并得到
+// Begin / Persist / End 事件。被移除的对象直接丢弃其配对，不产生 End 事件。
+// ============================================================================
+class SweepAndPrune {
+public:
+    SweepAndPrune() = default;
+
+    void insert(Node* node, const Rect& bounds);
+    void remove(Node* node);
+    void update(Node* node, const Rect& newBounds);
+    void clear();
+
+    size_t size() const { return lookup_.size(); }
+    bool empty() const { return lookup_.empty(); }
+
+    /// 修正排序并更新配对缓存与事件，通常每帧调用一次
+    void updatePairs();
+
+    /// 最近一次 updatePairs 得到的相交对
+    const std::vector<std::pair<Node*, Node*>>& getPairs() const { return pairs_; }
+
+    /// 最近一次 updatePairs 相对上一次的变化
+    const std::vector<CollisionEvent>& getEvents() const { return events_; }
+
+private:
+    static constexpr int32 INVALID = -1;
+
+    struct Proxy {
+        Node* node = nullptr;
+        Rect bounds;
+        int32 nextFree = INVALID;
+        bool alive = false;
+    };
+
+    // 排序数组中的包围盒：min/max 为排序轴，otherMin/otherMax 为另一轴
+    struct Box {
+        float min;
+        float max;
+        float otherMin;
+        float otherMax;
+        int32 proxy;
+    };
+
+    void chooseAxis();
+    void refreshBoxes();
+    void sortBoxes();
+    void findPairs(std::vector<uint64>& keys) const;
+    void diffPairs(const std::vector<uint64>& keys);
+    static uint64 makeKey(int32 a, int32 b);
+
+    std::vector<Proxy> proxies_;
+    int32 freeProxy_ = INVALID;
+    std::vector<int32> pendingFree_;    // 本轮被移除的代理，updatePairs 之后才复用，避免键冲突
+    std::unordered_map<Node*, int32> lookup_;
+
+    std::vector<Box> boxes_;
+    int axis_ = 0;                      // 0 = x，1 = y
+    bool fullSort_ = false;
+    size_t insertedSinceSort_ = 0;
+
+    std::vector<uint64> pairKeys_;      // 当前相交对（较小的代理下标在高 32 位），升序
+    std::vector<uint64> scratchKeys_;
+    std::vector<std::pair<Node*, Node*>> pairs_;
+    std::vector<CollisionEvent> events_;
+};
+
+}
@@ -2,6 +2,7 @@
 #include <easy2d/platform/window.h>
 #include <easy2d/platform/input.h>
 #include <easy2d/audio/audio_engine.h>
+#include <easy2d/core/job_system.h>
 #include <easy2d/scene/scene_manager.h>
 #include <easy2d/resource/resource_manager.h>
 #include <easy2d/utils/timer.h>
@@ -101,6 +102,9 @@ bool Application::init(const AppConfig& config) {
     // 初始化音频引擎
     AudioEngine::getInstance().initialize();
 
+    // 初始化任务系统
+    JobSystem::getInstance().initialize(config.jobThreads);
+
     initialized_ = true;
     running_ = true;
 
@@ -124,6 +128,9 @@ void Application::shutdown() {
     // 关闭音频
     AudioEngine::getInstance().shutdown();
 
+    // 关闭任务系统（场景等子系统已释放，不会再提交任务）
+    JobSystem::getInstance().shutdown();
+
     // 关闭渲染器
     if (renderer_) {
         renderer_->shutdown();
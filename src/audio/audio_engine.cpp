@@ -49,11 +49,11 @@ void AudioEngine::shutdown() {
     E2D_LOG_INFO("AudioEngine shutdown");
 }
 
-std::shared_ptr<Sound> AudioEngine::loadSound(const std::string& filePath) {
+Ptr<Sound> AudioEngine::loadSound(const std::string& filePath) {
     return loadSound(filePath, filePath);
 }
 
-std::shared_ptr<Sound> AudioEngine::loadSound(const std::string& name, const std::string& filePath) {
+Ptr<Sound> AudioEngine::loadSound(const std::string& name, const std::string& filePath) {
     if (!engine_) {
         E2D_LOG_ERROR("AudioEngine not initialized");
         return nullptr;
@@ -74,14 +74,14 @@ std::shared_ptr<Sound> AudioEngine::loadSound(const std::string& name, const std
         return nullptr;
     }
 
-    auto sound = std::shared_ptr<Sound>(new Sound(name, filePath, maSound));
+    auto sound = Ptr<Sound>(new Sound(name, filePath, maSound));
     sounds_[name] = sound;
 
     E2D_LOG_DEBUG("Loaded sound: {}", filePath);
     return sound;
 }
 
-std::shared_ptr<Sound> AudioEngine::getSound(const std::string& name) {
+Ptr<Sound> AudioEngine::getSound(const std::string& name) {
     auto it = sounds_.find(name);
     if (it != sounds_.end()) {
         return it->second;
@@ -0,0 +1,284 @@
+#include <easy2d/core/job_system.h>
+#include <easy2d/utils/logger.h>
+#include <chrono>
+
+namespace easy2d {
+
+namespace {
+
+// 当前线程在 queues_ 中的下标：工作线程为 1..N，其余线程共用 0
+thread_local uint32 tlsQueueIndex = 0;
+
+int64 nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+JobSystem& JobSystem::getInstance() {
+    static JobSystem instance;
+    return instance;
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+// ============================================================================
+// 生命周期
+// ============================================================================
+bool JobSystem::initialize(int threadCount) {
+    if (initialized_) {
+        return true;
+    }
+
+    if (threadCount < 0) {
+        int hardware = static_cast<int>(std::thread::hardware_concurrency());
+        threadCount = std::max(0, hardware - 1);
+    }
+
+    queues_.clear();
+    for (int i = 0; i <= threadCount; ++i) {
+        queues_.push_back(makeUnique<WorkerQueue>());
+    }
+
+    running_ = true;
+    initialized_ = true;
+    resetStats();
+
+    workers_.reserve(static_cast<size_t>(threadCount));
+    for (int i = 1; i <= threadCount; ++i) {
+        workers_.emplace_back(&JobSystem::workerLoop, this, static_cast<uint32>(i));
+    }
+
+    E2D_LOG_INFO("JobSystem initialized with {} worker thread(s)", threadCount);
+    return true;
+}
+
+void JobSystem::shutdown() {
+    if (!initialized_) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        running_ = false;
+    }
+    sleepCondition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+
+    // 仍在队列中的任务在当前线程执行完，保证计数器能够归零
+    Job job;
+    for (uint32 i = 0; i < queues_.size(); ++i) {
+        while (popLocal(i, job)) {
+            execute(0, job, false);
+        }
+    }
+
+    queues_.clear();
+    initialized_ = false;
+}
+
+// ============================================================================
+// 任务提交
+// ============================================================================
+void JobSystem::schedule(JobFunction function, JobCounter* counter) {
+    if (counter) {
+        counter->value_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    Job job{std::move(function), counter};
+    if (!initialized_) {
+        // 未初始化时退化为同步执行
+        job.function();
+        finish(counter);
+        return;
+    }
+    push(std::move(job));
+}
+
+void JobSystem::scheduleAfter(JobCounter& dependency, JobFunction function, JobCounter* counter) {
+    if (counter) {
+        counter->value_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex_);
+        if (!dependency.isDone()) {
+            dependency.continuations_.push_back(Job{std::move(function), counter});
+            return;
+        }
+    }
+
+    // 依赖已完成：计数已在上面增加，这里直接入队
+    Job job{std::move(function), counter};
+    if (!initialized_) {
+        job.function();
+        finish(counter);
+        return;
+    }
+    push(std::move(job));
+}
+
+void JobSystem::push(Job job) {
+    // 先计数再入队，保证出队时的递减不会先于递增
+    queuedJobs_.fetch_add(1);
+    uint32 index = tlsQueueIndex < queues_.size() ? tlsQueueIndex : 0;
+    {
+        WorkerQueue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    // 工作线程先登记为睡眠再检查 queuedJobs_，因此这里读到 0 时对方一定能看到新任务
+    if (sleepingWorkers_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleepMutex_); }
+        sleepCondition_.notify_one();
+    }
+}
+
+void JobSystem::wait(JobCounter& counter, bool participate) {
+    uint32 index = tlsQueueIndex < queues_.size() ? tlsQueueIndex : 0;
+    while (!counter.isDone()) {
+        if (!(participate && initialized_ && tryExecuteOne(index))) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 递减方在释放计数器锁之后才算真正结束，等它退出后调用方才能销毁计数器
+    std::lock_guard<std::mutex> lock(counter.mutex_);
+}
+
+// ============================================================================
+// 执行
+// ============================================================================
+void JobSystem::workerLoop(uint32 index) {
+    tlsQueueIndex = index;
+
+    while (running_) {
+        if (tryExecuteOne(index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepingWorkers_.fetch_add(1);
+        sleepCondition_.wait(lock, [this]() {
+            return !running_ || queuedJobs_.load() > 0;
+        });
+        sleepingWorkers_.fetch_sub(1);
+    }
+}
+
+bool JobSystem::popLocal(uint32 index, Job& job) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queuedJobs_.fetch_sub(1);
+    return true;
+}
+
+bool JobSystem::steal(uint32 index, Job& job) {
+    const uint32 count = static_cast<uint32>(queues_.size());
+    for (uint32 offset = 1; offset < count; ++offset) {
+        WorkerQueue& victim = *queues_[(index + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.jobs.empty()) {
+            continue;
+        }
+        job = std::move(victim.jobs.front());
+        victim.jobs.pop_front();
+        queuedJobs_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryExecuteOne(uint32 index) {
+    Job job;
+    if (popLocal(index, job)) {
+        execute(index, job, false);
+        return true;
+    }
+    if (steal(index, job)) {
+        execute(index, job, true);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::execute(uint32 index, Job& job, bool stolen) {
+    int64 start = nowNanoseconds();
+    job.function();
+    int64 elapsed = nowNanoseconds() - start;
+
+    WorkerQueue& queue = *queues_[index];
+    queue.jobsExecuted.fetch_add(1, std::memory_order_relaxed);
+    queue.busyNanoseconds.fetch_add(static_cast<uint64>(elapsed), std::memory_order_relaxed);
+    if (stolen) {
+        queue.jobsStolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    finish(job.counter);
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) {
+        return;
+    }
+
+    std::vector<Job> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex_);
+        if (counter->value_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter->continuations_);
+        }
+    }
+
+    // 依赖已满足的后续任务（其计数在 scheduleAfter 时已增加）
+    for (Job& job : ready) {
+        if (!initialized_) {
+            job.function();
+            finish(job.counter);
+        } else {
+            push(std::move(job));
+        }
+    }
+}
+
+// ============================================================================
+// 统计
+// ============================================================================
+std::vector<JobWorkerStats> JobSystem::getWorkerStats() const {
+    std::vector<JobWorkerStats> stats;
+    stats.reserve(queues_.size());
+
+    double elapsed = static_cast<double>(nowNanoseconds() - statsStartNanoseconds_.load()) * 1e-9;
+    for (const auto& queue : queues_) {
+        JobWorkerStats s;
+        s.jobsExecuted = queue->jobsExecuted.load(std::memory_order_relaxed);
+        s.jobsStolen = queue->jobsStolen.load(std::memory_order_relaxed);
+        s.busySeconds = static_cast<double>(queue->busyNanoseconds.load(std::memory_order_relaxed)) * 1e-9;
+        s.utilization = elapsed > 0.0 ? std::min(1.0, s.busySeconds / elapsed) : 0.0;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void JobSystem::resetStats() {
+    for (auto& queue : queues_) {
+        queue->jobsExecuted = 0;
+        queue->jobsStolen = 0;
+        queue->busyNanoseconds = 0;
+    }
+    statsStartNanoseconds_ = nowNanoseconds();
+}
+
+} // namespace easy2d
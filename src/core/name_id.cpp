@@ -0,0 +1,104 @@
+#include <easy2d/core/name_id.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace easy2d {
+
+namespace {
+
+// 名称按块存放：第 k 块容纳 FIRST_CHUNK_SIZE << k 个名称，块一经分配就不再移动，
+// 所以 string_view 键可以安全地指向其中的字符串，按 ID 取名称也无需加锁
+constexpr uint32 FIRST_CHUNK_SIZE = 256;
+constexpr uint32 MAX_CHUNKS = 25;   // 足以覆盖全部 uint32 ID
+
+struct NameTable {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string_view, uint32> ids;
+    uint32 count = 0;
+    std::atomic<std::string*> chunks[MAX_CHUNKS] = {};
+};
+
+NameTable& table() {
+    // 有意不析构：节点可能在静态析构阶段才释放
+    static NameTable* instance = new NameTable();
+    return *instance;
+}
+
+/// 名称序号（ID - 1）所在的块与块内偏移
+void locate(uint32 index, uint32& chunk, uint32& offset) {
+    uint32 scaled = index / FIRST_CHUNK_SIZE + 1;
+    chunk = 0;
+    while (scaled >>= 1) {
+        ++chunk;
+    }
+    offset = index - FIRST_CHUNK_SIZE * ((1u << chunk) - 1);
+}
+
+uint32 lookup(NameTable& t, std::string_view name) {
+    auto it = t.ids.find(name);
+    return it != t.ids.end() ? it->second : NameId::INVALID;
+}
+
+} // namespace
+
+NameId::NameId(std::string_view name) {
+    if (name.empty()) {
+        return;
+    }
+
+    NameTable& t = table();
+    {
+        std::shared_lock<std::shared_mutex> lock(t.mutex);
+        id_ = lookup(t, name);
+    }
+    if (id_ != INVALID) {
+        return;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(t.mutex);
+    id_ = lookup(t, name);   // 等待写锁期间可能已被其他线程驻留
+    if (id_ != INVALID) {
+        return;
+    }
+
+    uint32 chunk, offset;
+    locate(t.count, chunk, offset);
+    std::string* names = t.chunks[chunk].load(std::memory_order_relaxed);
+    if (!names) {
+        names = new std::string[static_cast<size_t>(FIRST_CHUNK_SIZE) << chunk];
+        t.chunks[chunk].store(names, std::memory_order_release);
+    }
+    names[offset] = std::string(name);
+
+    id_ = ++t.count;
+    t.ids.emplace(std::string_view(names[offset]), id_);
+}
+
+NameId NameId::find(std::string_view name) {
+    NameId result;
+    if (name.empty()) {
+        return result;
+    }
+
+    NameTable& t = table();
+    std::shared_lock<std::shared_mutex> lock(t.mutex);
+    result.id_ = lookup(t, name);
+    return result;
+}
+
+const std::string& NameId::str() const {
+    static const std::string empty;
+    if (id_ == INVALID) {
+        return empty;
+    }
+
+    // 持有 ID 说明驻留已先于此发生，名称写入后不再修改
+    uint32 chunk, offset;
+    locate(id_ - 1, chunk, offset);
+    return table().chunks[chunk].load(std::memory_order_acquire)[offset];
+}
+
+} // namespace easy2d
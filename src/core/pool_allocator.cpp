@@ -0,0 +1,124 @@
+#include <easy2d/core/pool_allocator.h>
+#include <easy2d/core/types.h>
+#include <atomic>
+
+namespace easy2d {
+
+// 引用计数模式标记（见 types.h）：使用方以不同模式编译时找不到对应符号而链接失败
+namespace detail {
+#if defined(E2D_SINGLE_THREADED_PTR)
+const int ptrModeSingleThreaded = 1;
+#else
+const int ptrModeAtomic = 1;
+#endif
+} // namespace detail
+
+namespace {
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+// 单个尺寸档位
+struct SizeClass {
+    FreeBlock* freeList = nullptr;
+    size_t liveBlocks = 0;
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+};
+
+constexpr size_t CLASS_COUNT = SlabPool::MAX_BLOCK_SIZE / SlabPool::GRANULARITY;
+
+struct PoolState {
+    SizeClass classes[CLASS_COUNT];
+    std::atomic<size_t> reservedBytes{0};
+};
+
+PoolState& state() {
+    // 有意不析构：静态对象持有的节点可能在程序退出时晚于本池释放
+    static PoolState* instance = new PoolState();
+    return *instance;
+}
+
+class ClassLock {
+public:
+    explicit ClassLock(SizeClass& sc) : sc_(sc) {
+        while (sc_.lock.test_and_set(std::memory_order_acquire)) {
+        }
+    }
+    ~ClassLock() {
+        sc_.lock.clear(std::memory_order_release);
+    }
+
+private:
+    SizeClass& sc_;
+};
+
+inline size_t classIndex(size_t size) {
+    return (size + SlabPool::GRANULARITY - 1) / SlabPool::GRANULARITY - 1;
+}
+
+// 新申请一个大块并切分为该档位的空闲块
+void refill(SizeClass& sc, size_t blockSize) {
+    size_t count = SlabPool::CHUNK_SIZE / blockSize;
+    char* chunk = static_cast<char*>(::operator new(count * blockSize));
+    state().reservedBytes.fetch_add(count * blockSize, std::memory_order_relaxed);
+
+    for (size_t i = count; i-- > 0;) {
+        auto* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+        block->next = sc.freeList;
+        sc.freeList = block;
+    }
+}
+
+} // namespace
+
+void* SlabPool::allocate(size_t size) {
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+        return ::operator new(size);
+    }
+
+    size_t index = classIndex(size);
+    SizeClass& sc = state().classes[index];
+    ClassLock lock(sc);
+
+    if (!sc.freeList) {
+        refill(sc, (index + 1) * GRANULARITY);
+    }
+    FreeBlock* block = sc.freeList;
+    sc.freeList = block->next;
+    sc.liveBlocks++;
+    return block;
+}
+
+void SlabPool::deallocate(void* ptr, size_t size) {
+    if (!ptr) {
+        return;
+    }
+    if (size == 0 || size > MAX_BLOCK_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    SizeClass& sc = state().classes[classIndex(size)];
+    ClassLock lock(sc);
+
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = sc.freeList;
+    sc.freeList = block;
+    sc.liveBlocks--;
+}
+
+size_t SlabPool::getLiveBlockCount() {
+    size_t total = 0;
+    for (SizeClass& sc : state().classes) {
+        ClassLock lock(sc);
+        total += sc.liveBlocks;
+    }
+    return total;
+}
+
+size_t SlabPool::getReservedBytes() {
+    return state().reservedBytes.load(std::memory_order_relaxed);
+}
+
+} // namespace easy2d
@@ -9,6 +9,7 @@ EventDispatcher::EventDispatcher() : nextId_(1) {
 ListenerId EventDispatcher::addListener(EventType type, EventCallback callback) {
     ListenerId id = nextId_++;
     listeners_[type].push_back({id, type, callback});
+    totalListeners_++;
     return id;
 }
 
@@ -17,6 +18,7 @@ void EventDispatcher::removeListener(ListenerId id) {
         auto it = std::remove_if(listeners.begin(), listeners.end(),
             [id](const Listener& l) { return l.id == id; });
         if (it != listeners.end()) {
+            totalListeners_ -= static_cast<size_t>(listeners.end() - it);
             listeners.erase(it, listeners.end());
             return;
         }
@@ -24,11 +26,16 @@ void EventDispatcher::removeListener(ListenerId id) {
 }
 
 void EventDispatcher::removeAllListeners(EventType type) {
-    listeners_.erase(type);
+    auto it = listeners_.find(type);
+    if (it != listeners_.end()) {
+        totalListeners_ -= it->second.size();
+        listeners_.erase(it);
+    }
 }
 
 void EventDispatcher::removeAllListeners() {
     listeners_.clear();
+    totalListeners_ = 0;
 }
 
 void EventDispatcher::dispatch(Event& event) {
@@ -58,12 +65,4 @@ size_t EventDispatcher::getListenerCount(EventType type) const {
     return (it != listeners_.end()) ? it->second.size() : 0;
 }
 
-size_t EventDispatcher::getTotalListenerCount() const {
-    size_t count = 0;
-    for (const auto& [type, listeners] : listeners_) {
-        count += listeners.size();
-    }
-    return count;
-}
-
 } // namespace easy2d
@@ -3,24 +3,38 @@
 #include <stb/stb_truetype.h>
 #define STB_RECT_PACK_IMPLEMENTATION
 #include <stb/stb_rect_pack.h>
+#include <easy2d/core/job_system.h>
 #include <easy2d/utils/logger.h>
 #include <fstream>
+#include <filesystem>
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <unordered_set>
 
 namespace easy2d {
 
+uint32 GLFontAtlas::frameIndex_ = 0;
+bool GLFontAtlas::uploadsPending_ = false;
+std::vector<GLFontAtlas*> GLFontAtlas::liveAtlases_;
+
 // ============================================================================
 // 构造函数 - 初始化字体图集
 // ============================================================================
 GLFontAtlas::GLFontAtlas(const std::string& filepath, int fontSize, bool useSDF)
     : fontSize_(fontSize)
     , useSDF_(useSDF)
-    , currentY_(0)
     , scale_(0.0f)
     , ascent_(0.0f)
     , descent_(0.0f)
     , lineGap_(0.0f) {
-    
+    liveAtlases_.push_back(this);
+    currentFrame_ = frameIndex_;
+    lastMaintenanceFrame_ = frameIndex_;
+
     // 加载字体文件
     std::ifstream file(filepath, std::ios::binary | std::ios::ate);
     if (!file.is_open()) {
@@ -56,18 +70,73 @@ GLFontAtlas::GLFontAtlas(const std::string& filepath, int fontSize, bool useSDF)
 // ============================================================================
 // 析构函数
 // ============================================================================
-GLFontAtlas::~GLFontAtlas() = default;
+GLFontAtlas::~GLFontAtlas() {
+    auto it = std::find(liveAtlases_.begin(), liveAtlases_.end(), this);
+    if (it != liveAtlases_.end()) {
+        liveAtlases_.erase(it);
+    }
+}
 
 // ============================================================================
 // 获取字形 - 如果字形不存在则缓存它
 // ============================================================================
 const Glyph* GLFontAtlas::getGlyph(char32_t codepoint) const {
+    if (pages_.empty()) {
+        return nullptr;
+    }
+
     auto it = glyphs_.find(codepoint);
     if (it == glyphs_.end()) {
         cacheGlyph(codepoint);
         it = glyphs_.find(codepoint);
+        if (it == glyphs_.end()) {
+            return nullptr;
+        }
+    }
+
+    // 记录使用帧（LRU）
+    CachedGlyph& cached = it->second;
+    cached.lastUsedFrame = currentFrame_;
+    if (cached.w > 0) {
+        pages_[static_cast<size_t>(cached.glyph.page)]->lastUsedFrame = currentFrame_;
+    }
+    return &cached.glyph;
+}
+
+Texture* GLFontAtlas::getPageTexture(int page) const {
+    if (page < 0 || page >= static_cast<int>(pages_.size())) {
+        return nullptr;
+    }
+    return pages_[static_cast<size_t>(page)]->texture.get();
+}
+
+void GLFontAtlas::setMaxPages(int maxPages) {
+    maxPages_ = std::clamp(maxPages, 1, MAX_PAGES);
+}
+
+void GLFontAtlas::touchGlyphRun(const GlyphRun& run) const {
+    // 页面级：每次提交都标记，保证本帧不会淘汰该网格引用的页面
+    for (size_t i = 0; i < pages_.size(); ++i) {
+        if (run.pageMask & (1u << i)) {
+            pages_[i]->lastUsedFrame = currentFrame_;
+        }
+    }
+
+    // 字形级：构建网格时已通过 getGlyph 记录，此后只需在淘汰期限内刷新一次
+    if (run.touchedFrame == GlyphRun::NEVER_TOUCHED) {
+        run.touchedFrame = currentFrame_;
+        return;
+    }
+    if (currentFrame_ - run.touchedFrame < evictionAge_ / 2) {
+        return;
+    }
+    run.touchedFrame = currentFrame_;
+    for (char32_t codepoint : run.codepoints) {
+        auto it = glyphs_.find(codepoint);
+        if (it != glyphs_.end()) {
+            it->second.lastUsedFrame = currentFrame_;
+        }
     }
-    return (it != glyphs_.end()) ? &it->second : nullptr;
 }
 
 // ============================================================================
@@ -97,163 +166,766 @@ Vec2 GLFontAtlas::measureText(const String& text) {
 }
 
 // ============================================================================
-// 创建图集纹理 - 初始化空白纹理和矩形打包上下文
+// 创建图集 - 初始化第一页
 // ============================================================================
 void GLFontAtlas::createAtlas() {
-    int channels = useSDF_ ? 1 : 4;
-    std::vector<uint8_t> emptyData(ATLAS_WIDTH * ATLAS_HEIGHT * channels, 0);
-    texture_ = std::make_unique<GLTexture>(ATLAS_WIDTH, ATLAS_HEIGHT, emptyData.data(), channels);
-    texture_->setFilter(true);
-    
-    // 初始化矩形打包上下文
-    packNodes_.resize(ATLAS_WIDTH);
-    stbrp_init_target(&packContext_, ATLAS_WIDTH, ATLAS_HEIGHT, packNodes_.data(), ATLAS_WIDTH);
+    addPage();
 }
 
 // ============================================================================
-// 缓存字形 - 渲染字形到图集并存储信息
-// 使用 stb_rect_pack 进行矩形打包
+// 缓存字形 - 光栅化字形并写入图集
 // ============================================================================
 void GLFontAtlas::cacheGlyph(char32_t codepoint) const {
+    RasterizedGlyph raster;
+    rasterizeGlyph(codepoint, raster);
+
+    if (raster.w <= 0 || raster.h <= 0) {
+        glyphs_[codepoint].glyph = raster.metrics;
+        return;
+    }
+    storeGlyph(codepoint, raster.metrics, raster.pixels.data(), raster.w, raster.h);
+}
+
+// ============================================================================
+// 光栅化字形 - 只读访问字体数据，可在工作线程中并发调用
+// ============================================================================
+void GLFontAtlas::rasterizeGlyph(char32_t codepoint, RasterizedGlyph& out) const {
+    out.codepoint = codepoint;
+    out.metrics = Glyph{};
+    out.w = 0;
+    out.h = 0;
+    out.pixels.clear();
+
     int advance = 0;
     stbtt_GetCodepointHMetrics(&fontInfo_, static_cast<int>(codepoint), &advance, nullptr);
-    float advancePx = advance * scale_;
+    out.metrics.advance = advance * scale_;
 
     if (useSDF_) {
-        constexpr int SDF_PADDING = 8;
-        constexpr unsigned char ONEDGE_VALUE = 128;
-        constexpr float PIXEL_DIST_SCALE = 64.0f;
-
         int w = 0, h = 0, xoff = 0, yoff = 0;
         unsigned char* sdf = stbtt_GetCodepointSDF(&fontInfo_,
                                                    scale_,
                                                    static_cast<int>(codepoint),
                                                    SDF_PADDING,
-                                                   ONEDGE_VALUE,
-                                                   PIXEL_DIST_SCALE,
+                                                   SDF_ONEDGE_VALUE,
+                                                   SDF_PIXEL_DIST_SCALE,
                                                    &w, &h, &xoff, &yoff);
         if (!sdf || w <= 0 || h <= 0) {
             if (sdf) stbtt_FreeSDF(sdf, nullptr);
-            Glyph glyph{};
-            glyph.advance = advancePx;
-            glyphs_[codepoint] = glyph;
             return;
         }
 
-        stbrp_rect rect;
-        rect.id = static_cast<int>(codepoint);
-        rect.w = w + PADDING * 2;
-        rect.h = h + PADDING * 2;
+        out.metrics.bearingX = static_cast<float>(xoff);
+        out.metrics.bearingY = static_cast<float>(yoff);
+        out.w = w;
+        out.h = h;
+        out.pixels.assign(sdf, sdf + static_cast<size_t>(w) * static_cast<size_t>(h));
+        stbtt_FreeSDF(sdf, nullptr);
+        return;
+    }
 
-        stbrp_pack_rects(&packContext_, &rect, 1);
-        if (!rect.was_packed) {
-            E2D_LOG_WARN("Font atlas is full, cannot cache codepoint: {}", static_cast<int>(codepoint));
-            stbtt_FreeSDF(sdf, nullptr);
-            return;
-        }
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    stbtt_GetCodepointBitmapBox(&fontInfo_, static_cast<int>(codepoint), scale_, scale_, &x0, &y0, &x1, &y1);
+    int w = x1 - x0;
+    int h = y1 - y0;
+    if (w <= 0 || h <= 0) {
+        return;
+    }
 
-        int atlasX = rect.x + PADDING;
-        int atlasY = rect.y + PADDING;
+    out.pixels.assign(static_cast<size_t>(w) * static_cast<size_t>(h), 0);
+    stbtt_MakeCodepointBitmap(&fontInfo_, out.pixels.data(), w, h, w, scale_, scale_, static_cast<int>(codepoint));
 
-        Glyph glyph;
-        glyph.width = static_cast<float>(w);
-        glyph.height = static_cast<float>(h);
-        glyph.bearingX = static_cast<float>(xoff);
-        glyph.bearingY = static_cast<float>(yoff);
-        glyph.advance = advancePx;
+    out.metrics.bearingX = static_cast<float>(x0);
+    out.metrics.bearingY = static_cast<float>(y0);
+    out.w = w;
+    out.h = h;
+}
 
-        // stb_rect_pack 使用左上角为原点，OpenGL纹理使用左下角为原点
-        // 需要翻转V坐标
-        float v0 = static_cast<float>(atlasY) / ATLAS_HEIGHT;
-        float v1 = static_cast<float>(atlasY + h) / ATLAS_HEIGHT;
-        glyph.u0 = static_cast<float>(atlasX) / ATLAS_WIDTH;
-        glyph.v0 = 1.0f - v1;  // 翻转V坐标
-        glyph.u1 = static_cast<float>(atlasX + w) / ATLAS_WIDTH;
-        glyph.v1 = 1.0f - v0;  // 翻转V坐标
+// ============================================================================
+// 存储字形 - 分配页内空间并写入暂存像素
+// ============================================================================
+void GLFontAtlas::storeGlyph(char32_t codepoint, const Glyph& metrics, const uint8_t* coverage, int w, int h) const {
+    int pageIndex = 0, x = 0, y = 0;
+    if (!allocateRect(w, h, pageIndex, x, y)) {
+        if (!fullWarnedThisFrame_) {
+            E2D_LOG_WARN("Font atlas is full ({} pages), cannot cache codepoint: {}",
+                         pages_.size(), static_cast<int>(codepoint));
+            fullWarnedThisFrame_ = true;
+        }
+        return;
+    }
+    placeGlyph(codepoint, metrics, coverage, w, h, pageIndex, x, y);
+}
 
-        glyphs_[codepoint] = glyph;
+void GLFontAtlas::placeGlyph(char32_t codepoint, const Glyph& metrics, const uint8_t* coverage,
+                             int w, int h, int pageIndex, int x, int y) const {
+    Page& page = *pages_[static_cast<size_t>(pageIndex)];
+    writePixels(page, x, y, w, h, coverage);
+    markDirty(page, x, y, w, h);
+    page.glyphCount++;
+
+    CachedGlyph& cached = glyphs_[codepoint];
+    cached.glyph = metrics;
+    cached.glyph.width = static_cast<float>(w);
+    cached.glyph.height = static_cast<float>(h);
+    cached.glyph.page = pageIndex;
+    cached.x = x;
+    cached.y = y;
+    cached.w = w;
+    cached.h = h;
+    cached.lastUsedFrame = currentFrame_;
+    updateGlyphUV(cached);
+
+    glyphsAddedThisFrame_ = true;
+}
 
-        glBindTexture(GL_TEXTURE_2D, texture_->getTextureID());
-        GLint prevUnpackAlignment = 4;
-        glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpackAlignment);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        // OpenGL纹理坐标原点在左下角，需要将Y坐标翻转
-        glTexSubImage2D(GL_TEXTURE_2D, 0, atlasX, ATLAS_HEIGHT - atlasY - h, w, h, GL_RED, GL_UNSIGNED_BYTE, sdf);
-        glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpackAlignment);
+// ============================================================================
+// 字形预热
+// ============================================================================
+void GLFontAtlas::prewarmCodepoints(const std::vector<char32_t>& codepoints, const std::string& cacheDir) {
+    if (pages_.empty()) {
+        return;
+    }
 
-        stbtt_FreeSDF(sdf, nullptr);
+    // 去重，并跳过已缓存或字体中不存在的字形
+    std::vector<char32_t> pending;
+    pending.reserve(codepoints.size());
+    std::unordered_set<char32_t> seen;
+    for (char32_t codepoint : codepoints) {
+        if (!seen.insert(codepoint).second || glyphs_.count(codepoint) > 0) {
+            continue;
+        }
+        if (stbtt_FindGlyphIndex(&fontInfo_, static_cast<int>(codepoint)) == 0) {
+            continue;
+        }
+        pending.push_back(codepoint);
+    }
+    if (pending.empty()) {
         return;
     }
 
-    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
-    stbtt_GetCodepointBitmapBox(&fontInfo_, static_cast<int>(codepoint), scale_, scale_, &x0, &y0, &x1, &y1);
-    int w = x1 - x0;
-    int h = y1 - y0;
-    int xoff = x0;
-    int yoff = y0;
+    std::vector<RasterizedGlyph> ready;
+    ready.reserve(pending.size());
+
+    // 1. 磁盘缓存命中的字形直接使用
+    std::unordered_map<char32_t, RasterizedGlyph> diskGlyphs;
+    std::string cachePath;
+    if (!cacheDir.empty()) {
+        cachePath = (std::filesystem::path(cacheDir) / (getCacheKey() + ".e2dglyphs")).string();
+        loadCacheFile(cachePath, diskGlyphs);
+
+        auto missing = pending.begin();
+        for (char32_t codepoint : pending) {
+            auto it = diskGlyphs.find(codepoint);
+            if (it != diskGlyphs.end()) {
+                ready.push_back(it->second);
+            } else {
+                *missing++ = codepoint;
+            }
+        }
+        pending.erase(missing, pending.end());
+    }
 
-    if (w <= 0 || h <= 0) {
-        Glyph glyph{};
-        glyph.advance = advancePx;
-        glyphs_[codepoint] = glyph;
+    // 2. 其余字形在工作线程中光栅化
+    size_t rasterizedCount = pending.size();
+    if (!pending.empty()) {
+        std::vector<RasterizedGlyph> rasterized;
+        rasterizeParallel(pending, rasterized);
+
+        if (!cachePath.empty()) {
+            for (const RasterizedGlyph& raster : rasterized) {
+                diskGlyphs[raster.codepoint] = raster;
+            }
+            saveCacheFile(cachePath, diskGlyphs);
+        }
+        std::move(rasterized.begin(), rasterized.end(), std::back_inserter(ready));
+    }
+
+    // 3. 批量打包进图集（像素在下一次绘制前统一上传）
+    size_t requested = ready.size();
+    commitBatch(ready);
+
+    E2D_LOG_INFO("Font atlas prewarmed {} glyphs ({} rasterized, {} from disk cache, size={}, sdf={})",
+                  requested, rasterizedCount, requested - rasterizedCount, fontSize_, useSDF_);
+}
+
+void GLFontAtlas::rasterizeParallel(const std::vector<char32_t>& codepoints,
+                                    std::vector<RasterizedGlyph>& out) const {
+    constexpr size_t CHUNK_SIZE = 16;
+
+    out.resize(codepoints.size());
+
+    // 任务系统可用时复用其工作线程，不再临时创建线程
+    JobSystem& jobs = JobSystem::getInstance();
+    if (jobs.isInitialized() && jobs.getWorkerCount() > 0) {
+        jobs.parallelFor(0, codepoints.size(), CHUNK_SIZE, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                rasterizeGlyph(codepoints[i], out[i]);
+            }
+        });
         return;
     }
 
-    std::vector<unsigned char> bitmap(static_cast<size_t>(w) * static_cast<size_t>(h), 0);
-    stbtt_MakeCodepointBitmap(&fontInfo_, bitmap.data(), w, h, w, scale_, scale_, static_cast<int>(codepoint));
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (;;) {
+            size_t begin = next.fetch_add(CHUNK_SIZE);
+            if (begin >= codepoints.size()) {
+                return;
+            }
+            size_t end = std::min(begin + CHUNK_SIZE, codepoints.size());
+            for (size_t i = begin; i < end; ++i) {
+                rasterizeGlyph(codepoints[i], out[i]);
+            }
+        }
+    };
 
-    // 使用 stb_rect_pack 打包矩形
-    stbrp_rect rect;
-    rect.id = static_cast<int>(codepoint);
+    // 字形较少时直接在当前线程完成，避免线程创建开销
+    size_t chunks = (codepoints.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    size_t threadCount = std::min(hardware, chunks) - 1;
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void GLFontAtlas::commitBatch(std::vector<RasterizedGlyph>& glyphs) const {
+    // 空白字形（空格等）只记录度量信息
+    std::vector<stbrp_rect> rects;
+    rects.reserve(glyphs.size());
+    for (size_t i = 0; i < glyphs.size(); ++i) {
+        const RasterizedGlyph& raster = glyphs[i];
+        if (raster.w <= 0 || raster.h <= 0) {
+            glyphs_[raster.codepoint].glyph = raster.metrics;
+            continue;
+        }
+        if (raster.w + PADDING * 2 > ATLAS_WIDTH || raster.h + PADDING * 2 > ATLAS_HEIGHT) {
+            continue;
+        }
+        stbrp_rect rect{};
+        rect.id = static_cast<int>(i);
+        rect.w = raster.w + PADDING * 2;
+        rect.h = raster.h + PADDING * 2;
+        rects.push_back(rect);
+    }
+
+    // 整批交给 stb_rect_pack 打包，放不下的留给下一页；预热不淘汰已有字形
+    auto packIntoPageBatch = [&](int pageIndex) {
+        Page& page = *pages_[static_cast<size_t>(pageIndex)];
+        stbrp_pack_rects(&page.packContext, rects.data(), static_cast<int>(rects.size()));
+
+        auto remaining = rects.begin();
+        for (const stbrp_rect& rect : rects) {
+            if (!rect.was_packed) {
+                *remaining++ = rect;
+                continue;
+            }
+            const RasterizedGlyph& raster = glyphs[static_cast<size_t>(rect.id)];
+            placeGlyph(raster.codepoint, raster.metrics, raster.pixels.data(), raster.w, raster.h,
+                       pageIndex, rect.x + PADDING, rect.y + PADDING);
+        }
+        rects.erase(remaining, rects.end());
+    };
+
+    // 先填充已有页面（从最新的页面开始），再在预算内新增页面
+    for (int i = static_cast<int>(pages_.size()) - 1; i >= 0 && !rects.empty(); --i) {
+        packIntoPageBatch(i);
+    }
+    while (!rects.empty() && static_cast<int>(pages_.size()) < maxPages_) {
+        addPage();
+        packIntoPageBatch(static_cast<int>(pages_.size()) - 1);
+    }
+
+    if (!rects.empty()) {
+        E2D_LOG_WARN("Font atlas page budget reached during prewarm, {} glyphs left for on-demand caching",
+                     rects.size());
+    }
+}
+
+// ============================================================================
+// 磁盘缓存
+// ============================================================================
+namespace {
+
+constexpr uint32 GLYPH_CACHE_MAGIC = 0x47443245;  // "E2DG"
+constexpr uint32 GLYPH_CACHE_VERSION = 1;
+
+struct GlyphCacheHeader {
+    uint32 magic;
+    uint32 version;
+    uint64 fontHash;
+    int32 fontSize;
+    int32 sdf;
+    int32 sdfPadding;
+    int32 sdfOnEdge;
+    float sdfDistScale;
+    uint32 glyphCount;
+};
+
+struct GlyphCacheRecord {
+    uint32 codepoint;
+    float advance;
+    float bearingX;
+    float bearingY;
+    int32 w;
+    int32 h;
+};
+
+} // namespace
+
+std::string GLFontAtlas::getCacheKey() const {
+    if (fontHash_ == 0) {
+        // FNV-1a 64
+        uint64 hash = 14695981039346656037ull;
+        for (unsigned char byte : fontData_) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+        fontHash_ = hash;
+    }
+
+    char key[64];
+    std::snprintf(key, sizeof(key), "%016llx_%d%s",
+                  static_cast<unsigned long long>(fontHash_), fontSize_, useSDF_ ? "_sdf" : "");
+    return key;
+}
+
+bool GLFontAtlas::loadCacheFile(const std::string& path, std::unordered_map<char32_t, RasterizedGlyph>& out) const {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    GlyphCacheHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return false;
+    }
+    getCacheKey();
+    if (header.magic != GLYPH_CACHE_MAGIC || header.version != GLYPH_CACHE_VERSION ||
+        header.fontHash != fontHash_ || header.fontSize != fontSize_ || header.sdf != (useSDF_ ? 1 : 0) ||
+        header.sdfPadding != SDF_PADDING || header.sdfOnEdge != SDF_ONEDGE_VALUE ||
+        header.sdfDistScale != SDF_PIXEL_DIST_SCALE) {
+        E2D_LOG_DEBUG("Ignoring stale glyph cache: {}", path);
+        return false;
+    }
+
+    out.reserve(out.size() + header.glyphCount);
+    for (uint32 i = 0; i < header.glyphCount; ++i) {
+        GlyphCacheRecord record{};
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record)) ||
+            record.w < 0 || record.h < 0 || record.w > ATLAS_WIDTH || record.h > ATLAS_HEIGHT) {
+            E2D_LOG_WARN("Corrupted glyph cache: {}", path);
+            out.clear();
+            return false;
+        }
+
+        RasterizedGlyph raster;
+        raster.codepoint = static_cast<char32_t>(record.codepoint);
+        raster.metrics.advance = record.advance;
+        raster.metrics.bearingX = record.bearingX;
+        raster.metrics.bearingY = record.bearingY;
+        raster.w = record.w;
+        raster.h = record.h;
+        raster.pixels.resize(static_cast<size_t>(record.w) * static_cast<size_t>(record.h));
+        if (!raster.pixels.empty() &&
+            !file.read(reinterpret_cast<char*>(raster.pixels.data()), static_cast<std::streamsize>(raster.pixels.size()))) {
+            E2D_LOG_WARN("Corrupted glyph cache: {}", path);
+            out.clear();
+            return false;
+        }
+        out[raster.codepoint] = std::move(raster);
+    }
+    return true;
+}
+
+bool GLFontAtlas::saveCacheFile(const std::string& path,
+                                const std::unordered_map<char32_t, RasterizedGlyph>& glyphs) const {
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    // 先写临时文件再替换，避免中途退出留下损坏的缓存
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            E2D_LOG_WARN("Failed to write glyph cache: {}", path);
+            return false;
+        }
+
+        getCacheKey();
+        GlyphCacheHeader header{};
+        header.magic = GLYPH_CACHE_MAGIC;
+        header.version = GLYPH_CACHE_VERSION;
+        header.fontHash = fontHash_;
+        header.fontSize = fontSize_;
+        header.sdf = useSDF_ ? 1 : 0;
+        header.sdfPadding = SDF_PADDING;
+        header.sdfOnEdge = SDF_ONEDGE_VALUE;
+        header.sdfDistScale = SDF_PIXEL_DIST_SCALE;
+        header.glyphCount = static_cast<uint32>(glyphs.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        for (const auto& [codepoint, raster] : glyphs) {
+            GlyphCacheRecord record{};
+            record.codepoint = static_cast<uint32>(codepoint);
+            record.advance = raster.metrics.advance;
+            record.bearingX = raster.metrics.bearingX;
+            record.bearingY = raster.metrics.bearingY;
+            record.w = raster.w;
+            record.h = raster.h;
+            file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            if (!raster.pixels.empty()) {
+                file.write(reinterpret_cast<const char*>(raster.pixels.data()),
+                           static_cast<std::streamsize>(raster.pixels.size()));
+            }
+        }
+        if (!file) {
+            E2D_LOG_WARN("Failed to write glyph cache: {}", path);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// 页面管理
+// ============================================================================
+GLFontAtlas::Page& GLFontAtlas::addPage() const {
+    auto page = std::make_unique<Page>();
+    page->pixels.assign(static_cast<size_t>(ATLAS_WIDTH) * ATLAS_HEIGHT, 0);
+    page->texture = std::make_unique<GLTexture>(ATLAS_WIDTH, ATLAS_HEIGHT, page->pixels.data(), 1);
+    page->texture->setFilter(true);
+
+    if (!useSDF_) {
+        // 位图字形只存覆盖率，采样时通过纹理 swizzle 展开为白色 RGB + Alpha，
+        // 与 RGBA 精灵共用同一着色器路径，显存占用为 RGBA 的 1/4
+        const GLint swizzle[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+    }
+
+    // 初始化矩形打包上下文
+    page->packNodes.resize(ATLAS_WIDTH);
+    stbrp_init_target(&page->packContext, ATLAS_WIDTH, ATLAS_HEIGHT, page->packNodes.data(), ATLAS_WIDTH);
+    page->lastUsedFrame = currentFrame_;
+
+    pages_.push_back(std::move(page));
+    if (pages_.size() > 1) {
+        E2D_LOG_DEBUG("Font atlas grew to {} pages (size={}, sdf={})", pages_.size(), fontSize_, useSDF_);
+    }
+    return *pages_.back();
+}
+
+void GLFontAtlas::resetPage(Page& page) const {
+    std::fill(page.pixels.begin(), page.pixels.end(), static_cast<uint8_t>(0));
+    stbrp_init_target(&page.packContext, ATLAS_WIDTH, ATLAS_HEIGHT, page.packNodes.data(), ATLAS_WIDTH);
+    page.glyphCount = 0;
+    markDirty(page, 0, 0, ATLAS_WIDTH, ATLAS_HEIGHT);
+}
+
+bool GLFontAtlas::packIntoPage(Page& page, int w, int h, int& x, int& y) const {
+    stbrp_rect rect{};
     rect.w = w + PADDING * 2;
     rect.h = h + PADDING * 2;
-    
-    stbrp_pack_rects(&packContext_, &rect, 1);
-    
+
+    stbrp_pack_rects(&page.packContext, &rect, 1);
     if (!rect.was_packed) {
-        // 图集已满，无法缓存更多字形
-        E2D_LOG_WARN("Font atlas is full, cannot cache codepoint: {}", static_cast<int>(codepoint));
+        return false;
+    }
+
+    x = rect.x + PADDING;
+    y = rect.y + PADDING;
+    return true;
+}
+
+bool GLFontAtlas::allocateRect(int w, int h, int& pageIndex, int& x, int& y) const {
+    if (w + PADDING * 2 > ATLAS_WIDTH || h + PADDING * 2 > ATLAS_HEIGHT) {
+        return false;
+    }
+
+    // 1. 尝试已有页面（从最新的页面开始，最可能有剩余空间）
+    for (int i = static_cast<int>(pages_.size()) - 1; i >= 0; --i) {
+        if (packIntoPage(*pages_[static_cast<size_t>(i)], w, h, x, y)) {
+            pageIndex = i;
+            return true;
+        }
+    }
+
+    // 2. 未达到页数预算时新增页面
+    if (static_cast<int>(pages_.size()) < maxPages_) {
+        Page& page = addPage();
+        pageIndex = static_cast<int>(pages_.size()) - 1;
+        return packIntoPage(page, w, h, x, y);
+    }
+
+    // 3. 淘汰本帧未使用且最久未使用的页面
+    //    本帧已提交的顶点不会引用该页，因此可以在帧中途安全清空
+    int victim = -1;
+    for (size_t i = 0; i < pages_.size(); ++i) {
+        const Page& page = *pages_[i];
+        if (page.lastUsedFrame == currentFrame_) {
+            continue;
+        }
+        if (victim < 0 || page.lastUsedFrame < pages_[static_cast<size_t>(victim)]->lastUsedFrame) {
+            victim = static_cast<int>(i);
+        }
+    }
+    if (victim < 0) {
+        return false;
+    }
+
+    evictPage(victim);
+    pageIndex = victim;
+    return packIntoPage(*pages_[static_cast<size_t>(victim)], w, h, x, y);
+}
+
+void GLFontAtlas::evictPage(int pageIndex) const {
+    for (auto it = glyphs_.begin(); it != glyphs_.end();) {
+        if (it->second.w > 0 && it->second.glyph.page == pageIndex) {
+            it = glyphs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    resetPage(*pages_[static_cast<size_t>(pageIndex)]);
+    generation_++;
+
+    E2D_LOG_DEBUG("Font atlas evicted page {} (size={}, sdf={})", pageIndex, fontSize_, useSDF_);
+}
+
+// ============================================================================
+// 整理页面 - 淘汰过期字形，并将剩余字形重新紧凑打包
+// ============================================================================
+void GLFontAtlas::compactPage(int pageIndex) const {
+    Page& page = *pages_[static_cast<size_t>(pageIndex)];
+
+    std::vector<CachedGlyph*> kept;
+    kept.reserve(static_cast<size_t>(page.glyphCount));
+    size_t evicted = 0;
+    for (auto it = glyphs_.begin(); it != glyphs_.end();) {
+        CachedGlyph& cached = it->second;
+        if (cached.w <= 0 || cached.glyph.page != pageIndex) {
+            ++it;
+            continue;
+        }
+        if (currentFrame_ - cached.lastUsedFrame > evictionAge_) {
+            it = glyphs_.erase(it);
+            evicted++;
+        } else {
+            kept.push_back(&cached);
+            ++it;
+        }
+    }
+
+    if (evicted == 0) {
+        return;
+    }
+
+    std::vector<uint8_t> oldPixels = page.pixels;
+    resetPage(page);
+
+    // 一次性打包所有保留的字形（stb_rect_pack 内部按高度排序，比逐个插入更紧凑）
+    std::vector<stbrp_rect> rects(kept.size());
+    for (size_t i = 0; i < kept.size(); ++i) {
+        rects[i] = stbrp_rect{};
+        rects[i].id = static_cast<int>(i);
+        rects[i].w = kept[i]->w + PADDING * 2;
+        rects[i].h = kept[i]->h + PADDING * 2;
+    }
+    if (!rects.empty()) {
+        stbrp_pack_rects(&page.packContext, rects.data(), static_cast<int>(rects.size()));
+    }
+
+    const size_t rowBytes = static_cast<size_t>(ATLAS_WIDTH);
+    size_t lost = 0;
+    for (size_t i = 0; i < kept.size(); ++i) {
+        CachedGlyph& cached = *kept[i];
+        if (!rects[i].was_packed) {
+            cached.w = -1;  // 标记待移除
+            lost++;
+            continue;
+        }
+
+        int newX = rects[i].x + PADDING;
+        int newY = rects[i].y + PADDING;
+        int oldTexY = ATLAS_HEIGHT - cached.y - cached.h;
+        int newTexY = ATLAS_HEIGHT - newY - cached.h;
+        for (int row = 0; row < cached.h; ++row) {
+            const uint8_t* src = oldPixels.data() + (oldTexY + row) * rowBytes + static_cast<size_t>(cached.x);
+            uint8_t* dst = page.pixels.data() + (newTexY + row) * rowBytes + static_cast<size_t>(newX);
+            std::memcpy(dst, src, static_cast<size_t>(cached.w));
+        }
+
+        cached.x = newX;
+        cached.y = newY;
+        updateGlyphUV(cached);
+        page.glyphCount++;
+    }
+
+    if (lost > 0) {
+        for (auto it = glyphs_.begin(); it != glyphs_.end();) {
+            if (it->second.w < 0) {
+                it = glyphs_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    generation_++;
+
+    E2D_LOG_DEBUG("Font atlas compacted page {}: evicted {}, kept {} glyphs",
+                  pageIndex, evicted + lost, page.glyphCount);
+}
+
+void GLFontAtlas::releaseTrailingPages() const {
+    // 只释放末尾的空页，保证其余字形的页索引不变
+    while (pages_.size() > 1 && pages_.back()->glyphCount == 0) {
+        pages_.pop_back();
+    }
+}
+
+// ============================================================================
+// 帧驱动
+// ============================================================================
+void GLFontAtlas::beginFrameAll() {
+    frameIndex_++;
+    for (GLFontAtlas* atlas : liveAtlases_) {
+        atlas->onFrameBegin(frameIndex_);
+    }
+}
+
+void GLFontAtlas::onFrameBegin(uint32 frame) const {
+    bool idle = !glyphsAddedThisFrame_;
+    currentFrame_ = frame;
+    glyphsAddedThisFrame_ = false;
+    fullWarnedThisFrame_ = false;
+
+    // 仅在空闲帧、且页数达到预算时整理，避免无压力时反复淘汰再重新光栅化
+    if (!idle || pages_.empty() || static_cast<int>(pages_.size()) < maxPages_ ||
+        frame - lastMaintenanceFrame_ < MAINTENANCE_INTERVAL) {
         return;
     }
+    lastMaintenanceFrame_ = frame;
 
-    int atlasX = rect.x + PADDING;
-    int atlasY = rect.y + PADDING;
+    // 选出过期字形最多的页面，每次最多整理一页以摊平开销
+    std::vector<int> staleCounts(pages_.size(), 0);
+    for (const auto& [codepoint, cached] : glyphs_) {
+        if (cached.w > 0 && frame - cached.lastUsedFrame > evictionAge_) {
+            staleCounts[static_cast<size_t>(cached.glyph.page)]++;
+        }
+    }
 
-    // 创建字形信息
-    Glyph glyph;
-    glyph.width = static_cast<float>(w);
-    glyph.height = static_cast<float>(h);
-    glyph.bearingX = static_cast<float>(xoff);
-    glyph.bearingY = static_cast<float>(yoff);
-    glyph.advance = advancePx;
+    auto best = std::max_element(staleCounts.begin(), staleCounts.end());
+    if (*best == 0) {
+        return;
+    }
+
+    compactPage(static_cast<int>(best - staleCounts.begin()));
+    releaseTrailingPages();
+}
+
+// ============================================================================
+// 像素写入与批量上传
+// ============================================================================
+void GLFontAtlas::writePixels(Page& page, int x, int y, int w, int h, const uint8_t* coverage) const {
+    // 暂存副本按 OpenGL 行序存放（原点在左下角），字形行按原顺序写入翻转后的区域
+    int texY = ATLAS_HEIGHT - y - h;
+    for (int row = 0; row < h; ++row) {
+        const uint8_t* src = coverage + static_cast<size_t>(row) * w;
+        uint8_t* dst = page.pixels.data() + static_cast<size_t>(texY + row) * ATLAS_WIDTH + x;
+        std::memcpy(dst, src, static_cast<size_t>(w));
+    }
+}
+
+void GLFontAtlas::markDirty(Page& page, int x, int y, int w, int h) const {
+    if (w == ATLAS_WIDTH && h == ATLAS_HEIGHT) {
+        page.dirtyRects.clear();
+    }
+    page.dirtyRects.push_back(DirtyRect{x, y, w, h});
+    uploadsPending_ = true;
+}
+
+void GLFontAtlas::flushPendingUploads() {
+    if (!uploadsPending_) {
+        return;
+    }
+    uploadsPending_ = false;
+
+    GLint prevUnpackAlignment = 4;
+    GLint prevRowLength = 0;
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &prevUnpackAlignment);
+    glGetIntegerv(GL_UNPACK_ROW_LENGTH, &prevRowLength);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, ATLAS_WIDTH);
+
+    for (GLFontAtlas* atlas : liveAtlases_) {
+        atlas->flushUploads();
+    }
+
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, prevRowLength);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, prevUnpackAlignment);
+}
+
+void GLFontAtlas::flushUploads() const {
+    for (auto& pagePtr : pages_) {
+        Page& page = *pagePtr;
+        if (page.dirtyRects.empty()) {
+            continue;
+        }
+
+        // 计算脏区域并集；区域过多或并集利用率较高时合并为一次上传
+        int left = ATLAS_WIDTH, top = ATLAS_HEIGHT, right = 0, bottom = 0;
+        size_t dirtyArea = 0;
+        for (const DirtyRect& rect : page.dirtyRects) {
+            left = std::min(left, rect.x);
+            top = std::min(top, rect.y);
+            right = std::max(right, rect.x + rect.w);
+            bottom = std::max(bottom, rect.y + rect.h);
+            dirtyArea += static_cast<size_t>(rect.w) * static_cast<size_t>(rect.h);
+        }
+        size_t unionArea = static_cast<size_t>(right - left) * static_cast<size_t>(bottom - top);
+
+        glBindTexture(GL_TEXTURE_2D, page.texture->getTextureID());
+        if (page.dirtyRects.size() > MAX_DIRTY_RECTS || dirtyArea * 2 >= unionArea) {
+            uploadRegion(page, DirtyRect{left, top, right - left, bottom - top});
+        } else {
+            for (const DirtyRect& rect : page.dirtyRects) {
+                uploadRegion(page, rect);
+            }
+        }
+        page.dirtyRects.clear();
+    }
+}
+
+void GLFontAtlas::uploadRegion(const Page& page, const DirtyRect& rect) const {
+    // 调用方负责绑定纹理并设置 GL_UNPACK_ROW_LENGTH / GL_UNPACK_ALIGNMENT
+    int texY = ATLAS_HEIGHT - rect.y - rect.h;
+    const uint8_t* data = page.pixels.data() + static_cast<size_t>(texY) * ATLAS_WIDTH + rect.x;
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x, texY, rect.w, rect.h, GL_RED, GL_UNSIGNED_BYTE, data);
+}
 
-    // 计算纹理坐标（相对于图集）
+void GLFontAtlas::updateGlyphUV(CachedGlyph& cached) const {
     // stb_rect_pack 使用左上角为原点，OpenGL纹理使用左下角为原点
     // 需要翻转V坐标
-    float v0 = static_cast<float>(atlasY) / ATLAS_HEIGHT;
-    float v1 = static_cast<float>(atlasY + h) / ATLAS_HEIGHT;
-    glyph.u0 = static_cast<float>(atlasX) / ATLAS_WIDTH;
-    glyph.v0 = 1.0f - v1;  // 翻转V坐标
-    glyph.u1 = static_cast<float>(atlasX + w) / ATLAS_WIDTH;
-    glyph.v1 = 1.0f - v0;  // 翻转V坐标
-
-    // 存储字形
-    glyphs_[codepoint] = glyph;
-
-    // 将单通道字形数据转换为 RGBA 格式（白色字形，Alpha 通道存储灰度）
-    std::vector<uint8_t> rgbaData(w * h * 4);
-    for (int i = 0; i < w * h; ++i) {
-        uint8_t alpha = bitmap[static_cast<size_t>(i)];
-        rgbaData[i * 4 + 0] = 255;  // R
-        rgbaData[i * 4 + 1] = 255;  // G
-        rgbaData[i * 4 + 2] = 255;  // B
-        rgbaData[i * 4 + 3] = alpha; // A
-    }
-
-    // 更新纹理 - 将字形数据上传到图集的指定位置
-    // OpenGL纹理坐标原点在左下角，需要将Y坐标翻转
-    glBindTexture(GL_TEXTURE_2D, texture_->getTextureID());
-    glTexSubImage2D(GL_TEXTURE_2D, 0, atlasX, ATLAS_HEIGHT - atlasY - h, w, h, GL_RGBA, GL_UNSIGNED_BYTE, rgbaData.data());
+    float v0 = static_cast<float>(cached.y) / ATLAS_HEIGHT;
+    float v1 = static_cast<float>(cached.y + cached.h) / ATLAS_HEIGHT;
+    cached.glyph.u0 = static_cast<float>(cached.x) / ATLAS_WIDTH;
+    cached.glyph.v0 = 1.0f - v1;  // 翻转V坐标
+    cached.glyph.u1 = static_cast<float>(cached.x + cached.w) / ATLAS_WIDTH;
+    cached.glyph.v1 = 1.0f - v0;  // 翻转V坐标
 }
 
 } // namespace easy2d
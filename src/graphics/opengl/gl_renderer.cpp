@@ -4,6 +4,8 @@
 #include <easy2d/platform/window.h>
 #include <easy2d/utils/logger.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <vector>
 
@@ -51,6 +53,8 @@ bool GLRenderer::init(Window* window) {
         E2D_LOG_ERROR("Failed to initialize sprite batch");
         return false;
     }
+    // 字体图集新字形在绘制前统一上传
+    spriteBatch_.setPreFlushCallback([]() { GLFontAtlas::flushPendingUploads(); });
 
     // 初始化形状渲染
     initShapeRendering();
@@ -82,6 +86,9 @@ void GLRenderer::beginFrame(const Color& clearColor) {
     glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT);
     resetStats();
+
+    // 推进字体图集的帧计数（LRU 淘汰与空闲帧整理）
+    GLFontAtlas::beginFrameAll();
 }
 
 void GLRenderer::endFrame() {
@@ -171,6 +178,21 @@ void GLRenderer::drawSprite(const Texture& texture, const Vec2& position, const
     drawSprite(texture, destRect, srcRect, tint, 0.0f, Vec2(0, 0));
 }
 
+void GLRenderer::drawSprite(const Texture& texture, const Rect& localRect, const Rect& srcRect,
+                           const Color& tint, const Affine2D& transform) {
+    float texW = static_cast<float>(texture.getWidth());
+    float texH = static_cast<float>(texture.getHeight());
+
+    // 纹理未在加载时翻转，图片第一行位于 v = 0，与屏幕 Y 向下一致；
+    // 保留 srcRect 的方向，翻转通过负宽高自然体现在 UV 上
+    glm::vec2 uv0(srcRect.origin.x / texW, srcRect.origin.y / texH);
+    glm::vec2 uv1((srcRect.origin.x + srcRect.size.width) / texW,
+                  (srcRect.origin.y + srcRect.size.height) / texH);
+
+    spriteBatch_.drawQuad(texture, transform, localRect, uv0, uv1,
+                          glm::vec4(tint.r, tint.g, tint.b, tint.a));
+}
+
 void GLRenderer::endSpriteBatch() {
     spriteBatch_.end();
     stats_.drawCalls += spriteBatch_.getDrawCallCount();
@@ -339,40 +361,53 @@ Ptr<FontAtlas> GLRenderer::createFontAtlas(const std::string& filepath, int font
 }
 
 void GLRenderer::drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color) {
-    drawText(font, text, position.x, position.y, color);
+    drawText(font, text, position, color, 1.0f);
 }
 
 void GLRenderer::drawText(const FontAtlas& font, const String& text, float x, float y, const Color& color) {
+    drawText(font, text, Vec2(x, y), color, 1.0f);
+}
+
+void GLRenderer::drawText(const FontAtlas& font, const String& text, const Vec2& position, const Color& color,
+                          float scale) {
+    float x = position.x;
     float cursorX = x;
-    float cursorY = y;
+    float cursorY = position.y;
     // 在屏幕坐标系中，Y轴向下，基线在字形下方
     // ascent是正值（向上），descent是负值（向下）
-    float baselineY = cursorY + font.getAscent();
+    float ascent = font.getAscent() * scale;
+    float lineHeight = font.getLineHeight() * scale;
+    float baselineY = cursorY + ascent;
     
     for (char32_t codepoint : text.toUtf32()) {
         if (codepoint == '\n') {
             cursorX = x;
-            cursorY += font.getLineHeight();
-            baselineY = cursorY + font.getAscent();
+            cursorY += lineHeight;
+            baselineY = cursorY + ascent;
             continue;
         }
         
         const Glyph* glyph = font.getGlyph(codepoint);
         if (glyph) {
             float penX = cursorX;
-            cursorX += glyph->advance;
+            cursorX += glyph->advance * scale;
 
             if (glyph->width <= 0.0f || glyph->height <= 0.0f) {
                 continue;
             }
 
+            Texture* pageTexture = font.getPageTexture(glyph->page);
+            if (!pageTexture) {
+                continue;
+            }
+
             // 字形位置计算
             // bearingX: 水平偏移
             // bearingY: 垂直偏移（负值表示在基线上方）
-            float xPos = penX + glyph->bearingX;
-            float yPos = baselineY + glyph->bearingY;
+            float xPos = penX + glyph->bearingX * scale;
+            float yPos = baselineY + glyph->bearingY * scale;
             
-            Rect destRect(xPos, yPos, glyph->width, glyph->height);
+            Rect destRect(xPos, yPos, glyph->width * scale, glyph->height * scale);
 
             
             // 字体纹理已经存储了正确的UV坐标，直接使用
@@ -385,11 +420,30 @@ void GLRenderer::drawText(const FontAtlas& font, const String& text, float x, fl
             data.rotation = 0.0f;
             data.anchor = glm::vec2(0.0f, 0.0f);
             data.isSDF = font.isSDF();
-            spriteBatch_.draw(*font.getTexture(), data);
+            spriteBatch_.draw(*pageTexture, data);
         }
     }
 }
 
+void GLRenderer::drawGlyphRun(const FontAtlas& font, const GlyphRun& run, const Vec2& position, const Color& color) {
+    // 图集淘汰或重新打包后旧网格的 UV 与页面都可能失效，必须由持有者重建
+    if (run.quads.empty() || run.generation != font.getGeneration()) {
+        return;
+    }
+    font.touchGlyphRun(run);
+
+    std::array<const Texture*, 32> pageTextures{};
+    int pageCount = std::min(font.getPageCount(), static_cast<int>(pageTextures.size()));
+    for (int i = 0; i < pageCount; ++i) {
+        pageTextures[static_cast<size_t>(i)] = font.getPageTexture(i);
+    }
+
+    spriteBatch_.drawGlyphQuads(run.quads.data(), run.quads.size(), pageTextures.data(), pageCount,
+                                glm::vec2(position.x, position.y),
+                                glm::vec4(color.r, color.g, color.b, color.a),
+                                font.isSDF());
+}
+
 void GLRenderer::resetStats() {
     stats_ = Stats{};
 }
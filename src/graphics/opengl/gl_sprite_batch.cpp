@@ -1,7 +1,9 @@
 #include <easy2d/graphics/opengl/gl_sprite_batch.h>
 #include <easy2d/utils/logger.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cstring>
+#include <string>
 
 namespace easy2d {
 
@@ -11,16 +13,19 @@ static const char* SPRITE_VERTEX_SHADER = R"(
 layout(location = 0) in vec2 aPosition;
 layout(location = 1) in vec2 aTexCoord;
 layout(location = 2) in vec4 aColor;
+layout(location = 3) in float aTexIndex;
 
 uniform mat4 uViewProjection;
 
 out vec2 vTexCoord;
 out vec4 vColor;
+flat out int vTexIndex;
 
 void main() {
     gl_Position = uViewProjection * vec4(aPosition, 0.0, 1.0);
     vTexCoord = aTexCoord;
     vColor = aColor;
+    vTexIndex = int(aTexIndex + 0.5);
 }
 )";
 
@@ -29,29 +34,45 @@ static const char* SPRITE_FRAGMENT_SHADER = R"(
 #version 330 core
 in vec2 vTexCoord;
 in vec4 vColor;
+flat in int vTexIndex;
 
-uniform sampler2D uTexture;
+uniform sampler2D uTextures[8];
 uniform int uUseSDF;
 uniform float uSdfOnEdge;
 uniform float uSdfScale;
 
 out vec4 fragColor;
 
+// GLSL 330 只允许用常量下标访问采样器数组，因此逐个分支采样
+vec4 sampleTexture(vec2 uv) {
+    switch (vTexIndex) {
+        case 0: return texture(uTextures[0], uv);
+        case 1: return texture(uTextures[1], uv);
+        case 2: return texture(uTextures[2], uv);
+        case 3: return texture(uTextures[3], uv);
+        case 4: return texture(uTextures[4], uv);
+        case 5: return texture(uTextures[5], uv);
+        case 6: return texture(uTextures[6], uv);
+        default: return texture(uTextures[7], uv);
+    }
+}
+
 void main() {
     if (uUseSDF == 1) {
-        float dist = texture(uTexture, vTexCoord).r;
+        float dist = sampleTexture(vTexCoord).r;
         float sd = (dist - uSdfOnEdge) * uSdfScale;
         float w = fwidth(sd);
         float alpha = smoothstep(-w, w, sd);
         fragColor = vec4(vColor.rgb, vColor.a * alpha);
     } else {
-        fragColor = texture(uTexture, vTexCoord) * vColor;
+        fragColor = sampleTexture(vTexCoord) * vColor;
     }
 }
 )";
 
 GLSpriteBatch::GLSpriteBatch()
-    : vao_(0), vbo_(0), ibo_(0), currentTexture_(nullptr), currentIsSDF_(false), drawCallCount_(0), spriteCount_(0) {
+    : vao_(0), vbo_(0), ibo_(0), textureSlotCount_(0), currentIsSDF_(false), drawCallCount_(0), spriteCount_(0) {
+    textureSlots_.fill(nullptr);
     vertices_.reserve(MAX_SPRITES * VERTICES_PER_SPRITE);
     indices_.reserve(MAX_SPRITES * INDICES_PER_SPRITE);
 }
@@ -67,6 +88,12 @@ bool GLSpriteBatch::init() {
         return false;
     }
 
+    // 采样器数组固定对应纹理单元 0..MAX_TEXTURE_SLOTS-1，只需设置一次
+    shader_.bind();
+    for (size_t i = 0; i < MAX_TEXTURE_SLOTS; ++i) {
+        shader_.setInt("uTextures[" + std::to_string(i) + "]", static_cast<int>(i));
+    }
+
     // 生成 VAO、VBO、IBO
     glGenVertexArrays(1, &vao_);
     glGenBuffers(1, &vbo_);
@@ -88,6 +115,9 @@ bool GLSpriteBatch::init() {
     glEnableVertexAttribArray(2);
     glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
 
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texIndex));
+
     // 生成索引缓冲区
     std::vector<GLuint> indices;
     indices.reserve(MAX_SPRITES * INDICES_PER_SPRITE);
@@ -127,55 +157,151 @@ void GLSpriteBatch::shutdown() {
 void GLSpriteBatch::begin(const glm::mat4& viewProjection) {
     viewProjection_ = viewProjection;
     vertices_.clear();
-    currentTexture_ = nullptr;
+    textureSlots_.fill(nullptr);
+    textureSlotCount_ = 0;
     currentIsSDF_ = false;
     drawCallCount_ = 0;
     spriteCount_ = 0;
 }
 
-void GLSpriteBatch::draw(const Texture& texture, const SpriteData& data) {
-    // 如果纹理改变或缓冲区已满，先 flush
-    if (currentTexture_ != nullptr && (currentTexture_ != &texture || currentIsSDF_ != data.isSDF || vertices_.size() >= MAX_SPRITES * VERTICES_PER_SPRITE)) {
+int GLSpriteBatch::acquireTextureSlot(const Texture& texture) {
+    for (size_t i = 0; i < textureSlotCount_; ++i) {
+        if (textureSlots_[i] == &texture) {
+            return static_cast<int>(i);
+        }
+    }
+    if (textureSlotCount_ >= MAX_TEXTURE_SLOTS) {
+        return -1;
+    }
+    textureSlots_[textureSlotCount_] = &texture;
+    return static_cast<int>(textureSlotCount_++);
+}
+
+int GLSpriteBatch::prepareQuad(const Texture& texture, bool isSDF) {
+    // SDF 模式改变或缓冲区已满，先 flush
+    if (!vertices_.empty() && (currentIsSDF_ != isSDF || vertices_.size() >= MAX_SPRITES * VERTICES_PER_SPRITE)) {
+        flush();
+    }
+
+    // 纹理槽位已满时才 flush，纹理切换本身不会打断批次
+    int slot = acquireTextureSlot(texture);
+    if (slot < 0) {
         flush();
+        slot = acquireTextureSlot(texture);
     }
 
-    currentTexture_ = &texture;
-    currentIsSDF_ = data.isSDF;
+    currentIsSDF_ = isSDF;
+    return slot;
+}
 
-    // 计算变换后的顶点位置
-    glm::vec2 anchorOffset(data.size.x * data.anchor.x, data.size.y * data.anchor.y);
-    
+void GLSpriteBatch::draw(const Texture& texture, const SpriteData& data) {
+    // 旧接口：位置 + 旋转（弧度），锚点在 size 内偏移
     float cosR = cosf(data.rotation);
     float sinR = sinf(data.rotation);
-    
-    auto transform = [&](float x, float y) -> glm::vec2 {
-        float rx = x - anchorOffset.x;
-        float ry = y - anchorOffset.y;
-        return glm::vec2(
-            data.position.x + rx * cosR - ry * sinR,
-            data.position.y + rx * sinR + ry * cosR
-        );
-    };
-
-    glm::vec4 color(data.color.r, data.color.g, data.color.b, data.color.a);
-
-    // 添加四个顶点（图片已在加载时翻转，纹理坐标直接使用）
+    Affine2D transform(cosR, sinR, -sinR, cosR, data.position.x, data.position.y);
+    Rect localRect(-data.size.x * data.anchor.x, -data.size.y * data.anchor.y, data.size.x, data.size.y);
+
+    drawQuad(texture, transform, localRect, data.texCoordMin, data.texCoordMax, data.color, data.isSDF);
+}
+
+void GLSpriteBatch::drawQuad(const Texture& texture, const Affine2D& transform, const Rect& localRect,
+                             const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color, bool isSDF) {
+    float texIndex = static_cast<float>(prepareQuad(texture, isSDF));
+
+    // 四个角一次变换完成，顺序与索引缓冲一致
     // v0(左上) -- v1(右上)
     //   |           |
     // v3(左下) -- v2(右下)
-    Vertex v0{ transform(0, 0), glm::vec2(data.texCoordMin.x, data.texCoordMin.y), color };
-    Vertex v1{ transform(data.size.x, 0), glm::vec2(data.texCoordMax.x, data.texCoordMin.y), color };
-    Vertex v2{ transform(data.size.x, data.size.y), glm::vec2(data.texCoordMax.x, data.texCoordMax.y), color };
-    Vertex v3{ transform(0, data.size.y), glm::vec2(data.texCoordMin.x, data.texCoordMax.y), color };
-
-    vertices_.push_back(v0);
-    vertices_.push_back(v1);
-    vertices_.push_back(v2);
-    vertices_.push_back(v3);
+    alignas(16) float xs[4];
+    alignas(16) float ys[4];
+    transform.transformCorners(localRect, xs, ys);
+
+    size_t base = vertices_.size();
+    vertices_.resize(base + VERTICES_PER_SPRITE);
+    Vertex* out = vertices_.data() + base;
+    out[0] = Vertex{ glm::vec2(xs[0], ys[0]), glm::vec2(uv0.x, uv0.y), color, texIndex };
+    out[1] = Vertex{ glm::vec2(xs[1], ys[1]), glm::vec2(uv1.x, uv0.y), color, texIndex };
+    out[2] = Vertex{ glm::vec2(xs[2], ys[2]), glm::vec2(uv1.x, uv1.y), color, texIndex };
+    out[3] = Vertex{ glm::vec2(xs[3], ys[3]), glm::vec2(uv0.x, uv1.y), color, texIndex };
 
     spriteCount_++;
 }
 
+void GLSpriteBatch::drawGlyphQuads(const GlyphQuad* quads, size_t count, const Texture* const* pageTextures,
+                                   int pageCount, const glm::vec2& offset, const glm::vec4& color, bool isSDF) {
+    if (count == 0) {
+        return;
+    }
+    if (!vertices_.empty() && currentIsSDF_ != isSDF) {
+        flush();
+    }
+    currentIsSDF_ = isSDF;
+
+    // 图集页到纹理槽位的映射，flush 后失效
+    std::array<int, 32> pageSlots;
+    pageSlots.fill(-1);
+    pageCount = std::min(pageCount, static_cast<int>(pageSlots.size()));
+
+    size_t i = 0;
+    while (i < count) {
+        size_t capacity = MAX_SPRITES - vertices_.size() / VERTICES_PER_SPRITE;
+        if (capacity == 0) {
+            flush();
+            pageSlots.fill(-1);
+            continue;
+        }
+
+        // 预先扩展顶点缓冲，随后直接写入，不再逐个 push_back
+        size_t n = std::min(capacity, count - i);
+        size_t base = vertices_.size();
+        vertices_.resize(base + n * VERTICES_PER_SPRITE);
+        Vertex* out = vertices_.data() + base;
+
+        // consumed：已处理（写入或跳过）的输入数；written：实际写入的四边形数
+        size_t consumed = 0;
+        size_t written = 0;
+        bool slotsFull = false;
+        for (; consumed < n; ++consumed) {
+            const GlyphQuad& q = quads[i + consumed];
+            // 页面已被淘汰（或网格来自别的图集）时跳过该字形
+            if (q.page < 0 || q.page >= pageCount || !pageTextures[q.page]) {
+                continue;
+            }
+            int& slot = pageSlots[static_cast<size_t>(q.page)];
+            if (slot < 0) {
+                slot = acquireTextureSlot(*pageTextures[q.page]);
+                if (slot < 0) {
+                    slotsFull = true;
+                    break;
+                }
+            }
+
+            float texIndex = static_cast<float>(slot);
+            float x0 = offset.x + q.x;
+            float y0 = offset.y + q.y;
+            float x1 = x0 + q.w;
+            float y1 = y0 + q.h;
+            out[0] = Vertex{ glm::vec2(x0, y0), glm::vec2(q.u0, q.v0), color, texIndex };
+            out[1] = Vertex{ glm::vec2(x1, y0), glm::vec2(q.u1, q.v0), color, texIndex };
+            out[2] = Vertex{ glm::vec2(x1, y1), glm::vec2(q.u1, q.v1), color, texIndex };
+            out[3] = Vertex{ glm::vec2(x0, y1), glm::vec2(q.u0, q.v1), color, texIndex };
+            out += VERTICES_PER_SPRITE;
+            ++written;
+        }
+
+        i += consumed;
+        spriteCount_ += static_cast<uint32_t>(written);
+        if (written < n) {
+            // 丢弃未写入的部分；纹理槽位已满时 flush 后继续
+            vertices_.resize(base + written * VERTICES_PER_SPRITE);
+            if (slotsFull) {
+                flush();
+                pageSlots.fill(-1);
+            }
+        }
+    }
+}
+
 void GLSpriteBatch::end() {
     if (!vertices_.empty()) {
         flush();
@@ -183,17 +309,23 @@ void GLSpriteBatch::end() {
 }
 
 void GLSpriteBatch::flush() {
-    if (vertices_.empty() || currentTexture_ == nullptr) return;
+    if (vertices_.empty() || textureSlotCount_ == 0) return;
+
+    if (preFlushCallback_) {
+        preFlushCallback_();
+    }
 
-    // 绑定纹理
-    GLuint texID = static_cast<GLuint>(reinterpret_cast<uintptr_t>(currentTexture_->getNativeHandle()));
+    // 绑定本批次用到的所有纹理
+    for (size_t i = 0; i < textureSlotCount_; ++i) {
+        GLuint texID = static_cast<GLuint>(reinterpret_cast<uintptr_t>(textureSlots_[i]->getNativeHandle()));
+        glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(i));
+        glBindTexture(GL_TEXTURE_2D, texID);
+    }
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texID);
 
     // 使用着色器
     shader_.bind();
     shader_.setMat4("uViewProjection", viewProjection_);
-    shader_.setInt("uTexture", 0);
     shader_.setInt("uUseSDF", currentIsSDF_ ? 1 : 0);
     shader_.setFloat("uSdfOnEdge", 128.0f / 255.0f);
     shader_.setFloat("uSdfScale", 255.0f / 64.0f);
@@ -209,6 +341,8 @@ void GLSpriteBatch::flush() {
 
     drawCallCount_++;
     vertices_.clear();
+    textureSlots_.fill(nullptr);
+    textureSlotCount_ = 0;
 }
 
 } // namespace easy2d
@@ -4,6 +4,7 @@
 #include <easy2d/audio/audio_engine.h>
 #include <easy2d/utils/logger.h>
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <cstring>
 
@@ -190,19 +191,76 @@ void ResourceManager::unloadTexture(const std::string& key) {
     E2D_LOG_DEBUG("ResourceManager: unloaded texture: {}", key);
 }
 
+std::string ResourceManager::getTextureKey(const Texture* texture) const {
+    if (!texture) {
+        return "";
+    }
+
+    std::lock_guard<std::mutex> lock(textureMutex_);
+    for (const auto& [key, weak] : textureCache_) {
+        if (auto cached = weak.lock(); cached.get() == texture) {
+            return key;
+        }
+    }
+    return "";
+}
+
 // ============================================================================
 // 字体图集资源
 // ============================================================================
 
 std::string ResourceManager::makeFontKey(const std::string& filepath, int fontSize, bool useSDF) const {
+    if (fontSize <= 0) {
+        return filepath + "#sdf";
+    }
     return filepath + "#" + std::to_string(fontSize) + (useSDF ? "#sdf" : "");
 }
 
 Ptr<FontAtlas> ResourceManager::loadFont(const std::string& filepath, int fontSize, bool useSDF) {
     std::lock_guard<std::mutex> lock(fontMutex_);
-    
-    std::string key = makeFontKey(filepath, fontSize, useSDF);
-    
+    return loadFontLocked(makeFontKey(filepath, fontSize, useSDF), filepath, fontSize, useSDF);
+}
+
+Ptr<FontAtlas> ResourceManager::loadSDFFont(const std::string& filepath) {
+    std::lock_guard<std::mutex> lock(fontMutex_);
+    return loadFontLocked(makeFontKey(filepath, 0, true), filepath, SDF_REFERENCE_FONT_SIZE, true);
+}
+
+Ptr<FontAtlas> ResourceManager::loadFontByKey(const std::string& key) {
+    // makeFontKey 的逆过程："path#sdf"、"path#size" 或 "path#size#sdf"
+    std::string filepath = key;
+    bool useSDF = false;
+    if (filepath.size() > 4 && filepath.compare(filepath.size() - 4, 4, "#sdf") == 0) {
+        filepath.resize(filepath.size() - 4);
+        useSDF = true;
+    }
+
+    // 键可能来自场景文件，字号解析失败（越界、为 0）时只报错返回空，不抛异常
+    int fontSize = 0;
+    size_t hash = filepath.rfind('#');
+    if (hash != std::string::npos && hash + 1 < filepath.size() &&
+        filepath.find_first_not_of("0123456789", hash + 1) == std::string::npos) {
+        const char* first = filepath.data() + hash + 1;
+        const char* last = filepath.data() + filepath.size();
+        auto result = std::from_chars(first, last, fontSize);
+        if (result.ec != std::errc() || result.ptr != last || fontSize <= 0) {
+            E2D_LOG_ERROR("ResourceManager: invalid font size in key: {}", key);
+            return nullptr;
+        }
+        filepath.resize(hash);
+    } else if (!useSDF) {
+        E2D_LOG_ERROR("ResourceManager: invalid font key: {}", key);
+        return nullptr;
+    }
+
+    if (fontSize <= 0) {
+        return loadSDFFont(filepath);
+    }
+    return loadFont(filepath, fontSize, useSDF);
+}
+
+Ptr<FontAtlas> ResourceManager::loadFontLocked(const std::string& key, const std::string& filepath,
+                                               int fontSize, bool useSDF) {
     // 检查缓存
     auto it = fontCache_.find(key);
     if (it != fontCache_.end()) {
@@ -265,6 +323,20 @@ void ResourceManager::unloadFont(const std::string& key) {
     E2D_LOG_DEBUG("ResourceManager: unloaded font: {}", key);
 }
 
+std::string ResourceManager::getFontKey(const FontAtlas* font) const {
+    if (!font) {
+        return "";
+    }
+
+    std::lock_guard<std::mutex> lock(fontMutex_);
+    for (const auto& [key, weak] : fontCache_) {
+        if (auto cached = weak.lock(); cached.get() == font) {
+            return key;
+        }
+    }
+    return "";
+}
+
 // ============================================================================
 // 音效资源
 // ============================================================================
@@ -8,11 +8,14 @@
 
 namespace easy2d {
 
-Node::Node() = default;
+Node::Node() {
+    transformIndex_ = transforms().allocate(this);
+}
 
 Node::~Node() {
     removeAllChildren();
     stopAllActions();
+    transforms().release(transformIndex_);
 }
 
 void Node::addChild(Ptr<Node> child) {
@@ -22,8 +25,18 @@ void Node::addChild(Ptr<Node> child) {
     
     child->removeFromParent();
     child->parent_ = weak_from_this();
-    children_.push_back(child);
-    childrenOrderDirty_ = true;
+    transforms().setParent(child->transformIndex_, transformIndex_);
+    // 子节点列表始终按 zOrder 稳定有序：插入到同 zOrder 节点之后，按顺序追加时即为尾部
+    child->childSeq_ = nextChildSeq_++;
+    auto pos = std::upper_bound(children_.begin(), children_.end(), child->zOrder_,
+        [](int z, const Ptr<Node>& n) { return z < n->zOrder_; });
+    children_.insert(pos, child);
+
+    if (childIndex_) {
+        indexChild(child.get());
+    } else if (children_.size() > CHILD_INDEX_THRESHOLD) {
+        buildChildIndex();
+    }
     
     if (running_) {
         child->onEnter();
@@ -43,6 +56,10 @@ void Node::removeChild(Ptr<Node> child) {
             (*it)->onExit();
         }
         (*it)->parent_.reset();
+        transforms().setParent((*it)->transformIndex_, TransformStore::INVALID_INDEX);
+        if (childIndex_) {
+            unindexChild(it->get());
+        }
         children_.erase(it);
     }
 }
@@ -68,20 +85,44 @@ void Node::removeAllChildren() {
             child->onExit();
         }
         child->parent_.reset();
+        transforms().setParent(child->transformIndex_, TransformStore::INVALID_INDEX);
     }
     children_.clear();
+    childIndex_.reset();
 }
 
 Ptr<Node> Node::getChildByName(const std::string& name) const {
+    return getChildByName(NameId::find(name));
+}
+
+Ptr<Node> Node::getChildByName(NameId name) const {
+    Node* child = findChild(name);
+    return child ? child->shared_from_this() : nullptr;
+}
+
+Node* Node::findChild(NameId name) const {
+    // 名称从未被驻留过时不可能有节点使用它
+    if (!name.isValid()) {
+        return nullptr;
+    }
+    if (childIndex_) {
+        auto it = childIndex_->byName.find(name);
+        return it != childIndex_->byName.end() ? it->second.front() : nullptr;
+    }
     for (const auto& child : children_) {
-        if (child->getName() == name) {
-            return child;
+        if (child->nameId_ == name) {
+            return child.get();
         }
     }
     return nullptr;
 }
 
 Ptr<Node> Node::getChildByTag(int tag) const {
+    // 默认标签不在索引中，退回线性扫描
+    if (childIndex_ && tag != DEFAULT_TAG) {
+        auto it = childIndex_->byTag.find(tag);
+        return it != childIndex_->byTag.end() ? it->second.front()->shared_from_this() : nullptr;
+    }
     for (const auto& child : children_) {
         if (child->getTag() == tag) {
             return child;
@@ -90,10 +131,125 @@ Ptr<Node> Node::getChildByTag(int tag) const {
     return nullptr;
 }
 
+Ptr<Node> Node::findByPath(std::string_view path) const {
+    const Node* node = this;
+    while (node && !path.empty()) {
+        size_t slash = path.find('/');
+        std::string_view segment = path.substr(0, slash);
+        path = (slash == std::string_view::npos) ? std::string_view() : path.substr(slash + 1);
+        if (segment.empty()) {
+            continue;   // 忽略多余的分隔符
+        }
+        node = node->findChild(NameId::find(segment));
+    }
+    if (!node || node == this) {
+        return nullptr;
+    }
+    return const_cast<Node*>(node)->shared_from_this();
+}
+
+NodeTagView Node::getDescendantsByTag(int tag) const {
+    return NodeTagView(transformIndex_, tag);
+}
+
+void Node::setName(const std::string& name) {
+    setName(NameId(name));
+}
+
+void Node::setName(NameId name) {
+    if (name == nameId_) {
+        return;
+    }
+    // 父节点索引以旧名称登记，需要先移除再重新登记
+    auto parent = parent_.lock();
+    bool indexed = parent && parent->childIndex_;
+    if (indexed) {
+        parent->unindexChild(this);
+    }
+    nameId_ = name;
+    if (indexed) {
+        parent->indexChild(this);
+    }
+}
+
+void Node::setTag(int tag) {
+    if (tag == tag_) {
+        return;
+    }
+    auto parent = parent_.lock();
+    bool indexed = parent && parent->childIndex_;
+    if (indexed) {
+        parent->unindexChild(this);
+    }
+    tag_ = tag;
+    if (indexed) {
+        parent->indexChild(this);
+    }
+}
+
+// ============================================================================
+// 子节点索引
+// ============================================================================
+namespace {
+
+template<typename Map, typename Key, typename Less>
+void insertEntry(Map& map, const Key& key, Node* child, Less less) {
+    auto& bucket = map[key];
+    bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), child, less), child);
+}
+
+template<typename Map, typename Key, typename Less>
+void eraseEntry(Map& map, const Key& key, Node* child, Less less) {
+    auto found = map.find(key);
+    if (found == map.end()) {
+        return;
+    }
+    auto& bucket = found->second;
+    auto it = std::lower_bound(bucket.begin(), bucket.end(), child, less);
+    if (it != bucket.end() && *it == child) {
+        bucket.erase(it);
+        if (bucket.empty()) {
+            map.erase(found);
+        }
+    }
+}
+
+} // namespace
+
+void Node::buildChildIndex() {
+    childIndex_ = makeUnique<ChildIndex>();
+    childIndex_->byName.reserve(children_.size());
+    childIndex_->byTag.reserve(children_.size());
+    for (const auto& child : children_) {
+        indexChild(child.get());
+    }
+}
+
+bool Node::childBefore(const Node* a, const Node* b) {
+    return a->zOrder_ != b->zOrder_ ? a->zOrder_ < b->zOrder_ : a->childSeq_ < b->childSeq_;
+}
+
+void Node::indexChild(Node* child) {
+    if (child->nameId_.isValid()) {
+        insertEntry(childIndex_->byName, child->nameId_, child, childBefore);
+    }
+    if (child->tag_ != DEFAULT_TAG) {
+        insertEntry(childIndex_->byTag, child->tag_, child, childBefore);
+    }
+}
+
+void Node::unindexChild(Node* child) {
+    if (child->nameId_.isValid()) {
+        eraseEntry(childIndex_->byName, child->nameId_, child, childBefore);
+    }
+    if (child->tag_ != DEFAULT_TAG) {
+        eraseEntry(childIndex_->byTag, child->tag_, child, childBefore);
+    }
+}
+
 void Node::setPosition(const Vec2& pos) {
-    position_ = pos;
-    transformDirty_ = true;
-    updateSpatialIndex();
+    transforms().setPosition(transformIndex_, pos);
+    markSpatialSubtreeDirty();
 }
 
 void Node::setPosition(float x, float y) {
@@ -101,15 +257,13 @@ void Node::setPosition(float x, float y) {
 }
 
 void Node::setRotation(float degrees) {
-    rotation_ = degrees;
-    transformDirty_ = true;
-    updateSpatialIndex();
+    transforms().setRotation(transformIndex_, degrees);
+    markSpatialSubtreeDirty();
 }
 
 void Node::setScale(const Vec2& scale) {
-    scale_ = scale;
-    transformDirty_ = true;
-    updateSpatialIndex();
+    transforms().setScale(transformIndex_, scale);
+    markSpatialSubtreeDirty();
 }
 
 void Node::setScale(float scale) {
@@ -121,8 +275,8 @@ void Node::setScale(float x, float y) {
 }
 
 void Node::setAnchor(const Vec2& anchor) {
-    anchor_ = anchor;
-    transformDirty_ = true;
+    transforms().setAnchor(transformIndex_, anchor);
+    updateSpatialIndex();
 }
 
 void Node::setAnchor(float x, float y) {
@@ -130,8 +284,8 @@ void Node::setAnchor(float x, float y) {
 }
 
 void Node::setSkew(const Vec2& skew) {
-    skew_ = skew;
-    transformDirty_ = true;
+    transforms().setSkew(transformIndex_, skew);
+    markSpatialSubtreeDirty();
 }
 
 void Node::setSkew(float x, float y) {
@@ -147,61 +301,69 @@ void Node::setVisible(bool visible) {
 }
 
 void Node::setZOrder(int zOrder) {
-    if (zOrder_ != zOrder) {
-        zOrder_ = zOrder;
-        childrenOrderDirty_ = true;
+    if (zOrder_ == zOrder) {
+        return;
+    }
+    int oldZOrder = zOrder_;
+    auto parent = parent_.lock();
+    // 索引按 (zOrder_, childSeq_) 排列，需以旧的排序键移除后再重新登记
+    bool indexed = parent && parent->childIndex_;
+    if (indexed) {
+        parent->unindexChild(this);
+    }
+    zOrder_ = zOrder;
+    if (parent) {
+        parent->reorderChild(this, oldZOrder);
+    }
+    if (indexed) {
+        parent->indexChild(this);
+    }
+}
+
+void Node::reorderChild(Node* child, int oldZOrder) {
+    // 旧 zOrder 所在区间内定位子节点（区间外的元素在此之前都保持有序）
+    auto first = std::lower_bound(children_.begin(), children_.end(), oldZOrder,
+        [child](const Ptr<Node>& n, int z) { return n.get() != child && n->zOrder_ < z; });
+    auto it = std::find_if(first, children_.end(),
+        [child](const Ptr<Node>& n) { return n.get() == child; });
+    if (it == children_.end()) {
+        return;
+    }
+
+    // 只在原位置与新位置之间旋转，效果与重新添加相同（排在同 zOrder 节点之后）
+    child->childSeq_ = nextChildSeq_++;
+    int z = child->zOrder_;
+    auto byZ = [](int value, const Ptr<Node>& n) { return value < n->zOrder_; };
+    if (z > oldZOrder) {
+        auto target = std::upper_bound(it + 1, children_.end(), z, byZ);
+        std::rotate(it, it + 1, target);
+    } else {
+        auto target = std::upper_bound(children_.begin(), it, z, byZ);
+        std::rotate(target, it, it + 1);
     }
 }
 
 Vec2 Node::convertToWorldSpace(const Vec2& localPos) const {
-    glm::vec4 worldPos = getWorldTransform() * glm::vec4(localPos.x, localPos.y, 0.0f, 1.0f);
-    return Vec2(worldPos.x, worldPos.y);
+    return getWorldTransform().transformPoint(localPos);
 }
 
 Vec2 Node::convertToNodeSpace(const Vec2& worldPos) const {
-    glm::mat4 invWorld = glm::inverse(getWorldTransform());
-    glm::vec4 localPos = invWorld * glm::vec4(worldPos.x, worldPos.y, 0.0f, 1.0f);
-    return Vec2(localPos.x, localPos.y);
-}
-
-glm::mat4 Node::getLocalTransform() const {
-    if (transformDirty_) {
-        localTransform_ = glm::mat4(1.0f);
-        
-        // T - R - S order
-        localTransform_ = glm::translate(localTransform_, glm::vec3(position_.x, position_.y, 0.0f));
-        
-        if (rotation_ != 0.0f) {
-            localTransform_ = glm::rotate(localTransform_, rotation_ * DEG_TO_RAD, glm::vec3(0.0f, 0.0f, 1.0f));
-        }
-        
-        if (skew_.x != 0.0f || skew_.y != 0.0f) {
-            glm::mat4 skewMatrix(1.0f);
-            skewMatrix[1][0] = std::tan(skew_.x * DEG_TO_RAD);
-            skewMatrix[0][1] = std::tan(skew_.y * DEG_TO_RAD);
-            localTransform_ *= skewMatrix;
-        }
-        
-        localTransform_ = glm::scale(localTransform_, glm::vec3(scale_.x, scale_.y, 1.0f));
-        
-        // Apply anchor point offset
-        localTransform_ = glm::translate(localTransform_, glm::vec3(-anchor_.x, -anchor_.y, 0.0f));
-        
-        transformDirty_ = false;
-    }
-    return localTransform_;
-}
-
-glm::mat4 Node::getWorldTransform() const {
-    if (transformDirty_) {
-        worldTransform_ = getLocalTransform();
-        
-        auto p = parent_.lock();
-        if (p) {
-            worldTransform_ = p->getWorldTransform() * worldTransform_;
-        }
+    return getWorldTransform().inverse().transformPoint(worldPos);
+}
+
+EventDispatcher& Node::getEventDispatcher() {
+    if (!eventDispatcher_) {
+        eventDispatcher_ = makeUnique<EventDispatcher>();
     }
-    return worldTransform_;
+    return *eventDispatcher_;
+}
+
+Affine2D Node::getLocalTransform() const {
+    return transforms().getLocalTransform(transformIndex_);
+}
+
+Affine2D Node::getWorldTransform() const {
+    return transforms().getWorldTransform(transformIndex_);
 }
 
 void Node::onEnter() {
@@ -231,10 +393,37 @@ void Node::onUpdate(float dt) {
             ++it;
         }
     }
-    
-    // Update children
-    for (auto& child : children_) {
-        child->onUpdate(dt);
+
+    // 子节点不再递归更新，由所在场景的更新列表统一调度
+}
+
+// ============================================================================
+// 更新注册
+// ============================================================================
+void Node::scheduleUpdate(int priority) {
+    updateScheduled_ = true;
+    if (updatePriority_ != priority) {
+        updatePriority_ = priority;
+        if (scene_ && isUpdateRegistered()) {
+            scene_->markUpdateListDirty();
+        }
+    }
+    registerUpdate();
+}
+
+void Node::unscheduleUpdate() {
+    // 只清除显式标记，列表中的节点在下一次更新后若无需更新会自动移出
+    updateScheduled_ = false;
+}
+
+bool Node::needsUpdate() const {
+    return updateScheduled_ || !actions_.empty() || wantsUpdate();
+}
+
+void Node::registerUpdate() {
+    // 场景根节点由 Scene::updateScene 直接更新，不进入自身列表
+    if (scene_ && scene_ != this && !isUpdateRegistered()) {
+        scene_->registerUpdate(this);
     }
 }
 
@@ -250,8 +439,11 @@ void Node::onRender(RenderBackend& renderer) {
 
 void Node::onAttachToScene(Scene* scene) {
     scene_ = scene;
+    if (needsUpdate()) {
+        registerUpdate();
+    }
     
-    // 添加到场景的空间索引
+    // 添加到场景的空间索引（随下一次提交一起插入）
     if (spatialIndexed_ && scene_) {
         lastSpatialBounds_ = Rect();
         updateSpatialIndex();
@@ -263,12 +455,19 @@ void Node::onAttachToScene(Scene* scene) {
 }
 
 void Node::onDetachFromScene() {
+    if (scene_ && spatialDirtySlot_ != INVALID_UPDATE_SLOT) {
+        scene_->unmarkSpatialDirty(this);
+    }
+
     // 从场景的空间索引移除
     if (spatialIndexed_ && scene_ && !lastSpatialBounds_.empty()) {
         scene_->removeNodeFromSpatialIndex(this);
         lastSpatialBounds_ = Rect();
     }
     
+    if (scene_ && isUpdateRegistered()) {
+        scene_->unregisterUpdate(this);
+    }
     scene_ = nullptr;
     for (auto& child : children_) {
         child->onDetachFromScene();
@@ -277,10 +476,31 @@ void Node::onDetachFromScene() {
 
 Rect Node::getBoundingBox() const {
     // 默认返回一个以位置为中心的点矩形
-    return Rect(position_.x, position_.y, 0, 0);
+    Vec2 pos = getPosition();
+    return Rect(pos.x, pos.y, 0, 0);
 }
 
 void Node::updateSpatialIndex() {
+    if (spatialIndexed_ && scene_ && spatialDirtySlot_ == INVALID_UPDATE_SLOT) {
+        scene_->markSpatialDirty(this);
+    }
+}
+
+void Node::markSpatialSubtreeDirty() {
+    // 世界包围盒依赖所有祖先的变换，变换改变时子树中参与索引的节点都要重新提交
+    if (!scene_ || spatialSubtreeDirty_) {
+        return;
+    }
+    if (spatialIndexed_) {
+        updateSpatialIndex();
+        spatialSubtreeDirty_ = true;
+    }
+    for (auto& child : children_) {
+        child->markSpatialSubtreeDirty();
+    }
+}
+
+void Node::syncSpatialIndex() {
     if (!spatialIndexed_ || !scene_) {
         return;
     }
@@ -296,6 +516,7 @@ void Node::runAction(Ptr<Action> action) {
     if (action) {
         action->start(this);
         actions_.push_back(action);
+        registerUpdate();
     }
 }
 
@@ -330,18 +551,15 @@ void Node::update(float dt) {
 }
 
 void Node::render(RenderBackend& renderer) {
-    if (childrenOrderDirty_) {
-        sortChildren();
-    }
     onRender(renderer);
 }
 
 void Node::sortChildren() {
-    std::sort(children_.begin(), children_.end(),
+    // 子节点列表已在增删与 setZOrder 时保持有序，这里仅作为完整重排的兜底
+    std::stable_sort(children_.begin(), children_.end(),
         [](const Ptr<Node>& a, const Ptr<Node>& b) {
             return a->getZOrder() < b->getZOrder();
         });
-    childrenOrderDirty_ = false;
 }
 
 void Node::collectRenderCommands(std::vector<RenderCommand>& commands, int parentZOrder) {
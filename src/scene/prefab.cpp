@@ -0,0 +1,129 @@
+#include <easy2d/scene/prefab.h>
+#include <easy2d/scene/scene_serializer.h>
+#include <easy2d/scene/transform_store.h>
+
+namespace easy2d {
+
+Ptr<Prefab> Prefab::create(const Node& root) {
+    auto prefab = makePtr<Prefab>();
+    prefab->capture(root);
+    return prefab;
+}
+
+Ptr<Prefab> Prefab::createFromFile(const std::string& filepath) {
+    Ptr<Node> root = SceneSerializer::load(filepath);
+    if (!root) {
+        return nullptr;
+    }
+    return create(*root);
+}
+
+// ============================================================================
+// 捕获
+// ============================================================================
+void Prefab::capture(const Node& root) {
+    nodes_.clear();
+
+    // 先序遍历，与 SceneSerializer 的节点顺序一致
+    std::vector<std::pair<const Node*, uint32>> stack;
+    stack.emplace_back(&root, 0);
+    while (!stack.empty()) {
+        auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        uint32 index = static_cast<uint32>(nodes_.size());
+        PrefabNode entry;
+        entry.type = &SceneSerializer::getNodeType(*node);
+        entry.parent = parent;
+        entry.childCount = static_cast<uint32>(node->getChildren().size());
+        entry.name = node->getNameId();
+        entry.tag = node->getTag();
+        entry.zOrder = node->getZOrder();
+        entry.position = node->getPosition();
+        entry.rotation = node->getRotation();
+        entry.scale = node->getScale();
+        entry.anchor = node->getAnchor();
+        entry.skew = node->getSkew();
+        entry.opacity = node->getOpacity();
+        entry.visible = node->isVisible();
+        entry.spatialIndexed = node->isSpatialIndexed();
+
+        if (entry.type->copy) {
+            entry.state = entry.type->create();
+            entry.type->copy(*node, *entry.state);
+        }
+        nodes_.push_back(std::move(entry));
+
+        const auto& children = node->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+}
+
+// ============================================================================
+// 实例化
+// ============================================================================
+Ptr<Node> Prefab::instantiate() const {
+    if (nodes_.empty()) {
+        return nullptr;
+    }
+
+    TransformStore::getInstance().reserve(nodes_.size());
+    std::vector<Node*> created(nodes_.size());
+    return build(created);
+}
+
+void Prefab::instantiate(size_t count, std::vector<Ptr<Node>>& out) const {
+    if (nodes_.empty() || count == 0) {
+        return;
+    }
+
+    TransformStore::getInstance().reserve(nodes_.size() * count);
+    out.reserve(out.size() + count);
+    std::vector<Node*> created(nodes_.size());
+    for (size_t i = 0; i < count; ++i) {
+        out.push_back(build(created));
+    }
+}
+
+Ptr<Node> Prefab::build(std::vector<Node*>& created) const {
+    TransformStore& transforms = TransformStore::getInstance();
+    Ptr<Node> root;
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        const PrefabNode& entry = nodes_[i];
+
+        // 新节点尚未挂接：名称/标签/zOrder 不涉及父节点索引，变换直接写入槽位
+        Ptr<Node> node = entry.type->create();
+        node->nameId_ = entry.name;
+        node->tag_ = entry.tag;
+        node->zOrder_ = entry.zOrder;
+        node->opacity_ = entry.opacity;
+        node->visible_ = entry.visible;
+        node->spatialIndexed_ = entry.spatialIndexed;
+
+        uint32 slot = node->transformIndex_;
+        transforms.positionRef(slot) = entry.position;
+        transforms.rotationRef(slot) = entry.rotation;
+        transforms.scaleRef(slot) = entry.scale;
+        transforms.anchorRef(slot) = entry.anchor;
+        transforms.skewRef(slot) = entry.skew;
+        transforms.markDirty(slot);
+
+        if (entry.state) {
+            entry.type->copy(*entry.state, *node);
+        }
+        node->reserveChildren(entry.childCount);
+
+        created[i] = node.get();
+        if (i == 0) {
+            root = std::move(node);
+        } else {
+            // 子节点按捕获时的 zOrder 顺序依次追加，addChild 总是插入到尾部
+            created[entry.parent]->addChild(std::move(node));
+        }
+    }
+    return root;
+}
+
+} // namespace easy2d
@@ -2,6 +2,7 @@
 #include <easy2d/graphics/render_backend.h>
 #include <easy2d/graphics/render_command.h>
 #include <easy2d/utils/logger.h>
+#include <algorithm>
 
 namespace easy2d {
 
@@ -9,6 +10,21 @@ Scene::Scene() {
     defaultCamera_ = makePtr<Camera>();
 }
 
+Scene::~Scene() {
+    // 基类析构时仍可能分离子节点，先让登记的节点忘记槽位，避免访问已销毁的列表
+    for (Node* node : updateList_) {
+        if (node) {
+            node->updateSlot_ = Node::INVALID_UPDATE_SLOT;
+        }
+    }
+    for (Node* node : spatialDirty_) {
+        if (node) {
+            node->spatialDirtySlot_ = Node::INVALID_UPDATE_SLOT;
+            node->spatialSubtreeDirty_ = false;
+        }
+    }
+}
+
 void Scene::setCamera(Ptr<Camera> camera) {
     camera_ = camera;
 }
@@ -52,6 +68,53 @@ void Scene::renderContent(RenderBackend& renderer) {
 void Scene::updateScene(float dt) {
     if (!paused_) {
         update(dt);
+        updateRegisteredNodes(dt);
+    }
+    flushSpatialIndex();
+}
+
+// ============================================================================
+// 更新注册表
+// ============================================================================
+void Scene::registerUpdate(Node* node) {
+    node->updateSlot_ = static_cast<uint32>(updateList_.size());
+    updateList_.push_back(node);
+    updateListDirty_ = true;
+}
+
+void Scene::unregisterUpdate(Node* node) {
+    updateList_[node->updateSlot_] = nullptr;
+    node->updateSlot_ = Node::INVALID_UPDATE_SLOT;
+    updateListHoles_++;
+}
+
+void Scene::updateRegisteredNodes(float dt) {
+    if (updateListHoles_ > 0 || updateListDirty_) {
+        updateList_.erase(std::remove(updateList_.begin(), updateList_.end(), nullptr), updateList_.end());
+        // 同优先级保持登记顺序（登记按先父后子进行，与原先的递归顺序一致）
+        std::stable_sort(updateList_.begin(), updateList_.end(),
+            [](const Node* a, const Node* b) {
+                return a->getUpdatePriority() < b->getUpdatePriority();
+            });
+        for (size_t i = 0; i < updateList_.size(); ++i) {
+            updateList_[i]->updateSlot_ = static_cast<uint32>(i);
+        }
+        updateListHoles_ = 0;
+        updateListDirty_ = false;
+    }
+
+    // 本帧新登记的节点从下一帧开始更新
+    const size_t count = updateList_.size();
+    for (size_t i = 0; i < count; ++i) {
+        Node* node = updateList_[i];
+        if (!node) {
+            continue;
+        }
+        node->onUpdate(dt);
+        // 更新回调中节点可能已被移出场景（槽位已置空），此时不能再访问它
+        if (updateList_[i] == node && !node->needsUpdate()) {
+            unregisterUpdate(node);
+        }
     }
 }
 
@@ -66,6 +129,14 @@ void Scene::onEnter() {
 
 void Scene::onExit() {
     // 清理空间索引
+    for (Node* node : spatialDirty_) {
+        if (node) {
+            node->spatialDirtySlot_ = Node::INVALID_UPDATE_SLOT;
+            node->spatialSubtreeDirty_ = false;
+        }
+    }
+    spatialDirty_.clear();
+    spatialDirtyHoles_ = 0;
     spatialManager_.clear();
     Node::onExit();
 }
@@ -75,13 +146,12 @@ void Scene::updateNodeInSpatialIndex(Node* node, const Rect& oldBounds, const Re
         return;
     }
     
-    // 如果旧边界有效，先移除
-    if (!oldBounds.empty()) {
+    // 新旧边界都有效时原地更新，由索引决定是否需要移动
+    if (!oldBounds.empty() && !newBounds.empty()) {
+        spatialManager_.update(node, newBounds);
+    } else if (!oldBounds.empty()) {
         spatialManager_.remove(node);
-    }
-    
-    // 如果新边界有效，插入
-    if (!newBounds.empty()) {
+    } else if (!newBounds.empty()) {
         spatialManager_.insert(node, newBounds);
     }
 }
@@ -94,10 +164,37 @@ void Scene::removeNodeFromSpatialIndex(Node* node) {
     spatialManager_.remove(node);
 }
 
+void Scene::markSpatialDirty(Node* node) {
+    node->spatialDirtySlot_ = static_cast<uint32>(spatialDirty_.size());
+    spatialDirty_.push_back(node);
+}
+
+void Scene::unmarkSpatialDirty(Node* node) {
+    spatialDirty_[node->spatialDirtySlot_] = nullptr;
+    node->spatialDirtySlot_ = Node::INVALID_UPDATE_SLOT;
+    node->spatialSubtreeDirty_ = false;
+    spatialDirtyHoles_++;
+}
+
+void Scene::flushSpatialIndex() const {
+    // 提交过程中节点不会再登记（边界只读），按登记顺序逐个写入；
+    // 各索引的原地更新都比清空后整体重建便宜，即使大部分节点都移动了也逐个提交
+    for (Node* node : spatialDirty_) {
+        if (node) {
+            node->spatialDirtySlot_ = Node::INVALID_UPDATE_SLOT;
+            node->spatialSubtreeDirty_ = false;
+            node->syncSpatialIndex();
+        }
+    }
+    spatialDirty_.clear();
+    spatialDirtyHoles_ = 0;
+}
+
 std::vector<Node*> Scene::queryNodesInArea(const Rect& area) const {
     if (!spatialIndexingEnabled_) {
         return {};
     }
+    flushSpatialIndex();
     return spatialManager_.query(area);
 }
 
@@ -105,13 +202,31 @@ std::vector<Node*> Scene::queryNodesAtPoint(const Vec2& point) const {
     if (!spatialIndexingEnabled_) {
         return {};
     }
+    flushSpatialIndex();
     return spatialManager_.query(point);
 }
 
+void Scene::queryNodesInArea(const Rect& area, std::vector<Node*>& results) const {
+    if (!spatialIndexingEnabled_) {
+        return;
+    }
+    flushSpatialIndex();
+    spatialManager_.query(area, results);
+}
+
+void Scene::queryNodesAtPoint(const Vec2& point, std::vector<Node*>& results) const {
+    if (!spatialIndexingEnabled_) {
+        return;
+    }
+    flushSpatialIndex();
+    spatialManager_.query(point, results);
+}
+
 std::vector<std::pair<Node*, Node*>> Scene::queryCollisions() const {
     if (!spatialIndexingEnabled_) {
         return {};
     }
+    flushSpatialIndex();
     return spatialManager_.queryCollisions();
 }
 
@@ -11,30 +11,26 @@ namespace easy2d {
 
 namespace {
 
-Node* hitTestTopmost(const Ptr<Node>& node, const Vec2& worldPos) {
+Node* hitTestTopmost(Node* node, const Vec2& worldPos) {
     if (!node || !node->isVisible()) {
         return nullptr;
     }
 
-    std::vector<Ptr<Node>> children = node->getChildren();
-    std::stable_sort(children.begin(), children.end(),
-        [](const Ptr<Node>& a, const Ptr<Node>& b) {
-            return a->getZOrder() < b->getZOrder();
-        });
-
+    // 子节点列表已按 zOrder 稳定有序，逆序遍历即从最上层开始，无需复制与排序
+    const auto& children = node->getChildren();
     for (auto it = children.rbegin(); it != children.rend(); ++it) {
-        if (Node* hit = hitTestTopmost(*it, worldPos)) {
+        if (Node* hit = hitTestTopmost(it->get(), worldPos)) {
             return hit;
         }
     }
 
-    if (node->getEventDispatcher().getTotalListenerCount() == 0) {
+    if (!node->hasEventListeners()) {
         return nullptr;
     }
 
     Rect bounds = node->getBoundingBox();
     if (!bounds.empty() && bounds.containsPoint(worldPos)) {
-        return node.get();
+        return node;
     }
 
     return nullptr;
@@ -44,7 +40,9 @@ void dispatchToNode(Node* node, Event& event) {
     if (!node) {
         return;
     }
-    node->getEventDispatcher().dispatch(event);
+    if (EventDispatcher* dispatcher = node->findEventDispatcher()) {
+        dispatcher->dispatch(event);
+    }
 }
 
 } // namespace
@@ -441,6 +439,9 @@ void SceneManager::update(float dt) {
             dispatchPointerEvents(scene);
         }
     }
+
+    // 本帧的变换修改已全部完成，一次线性遍历刷新世界变换
+    TransformStore::getInstance().updateWorldTransforms();
 }
 
 void SceneManager::render(RenderBackend& renderer) {
@@ -602,8 +603,7 @@ void SceneManager::dispatchPointerEvents(Scene& scene) {
         worldPos = camera->screenToWorld(screenPos);
     }
 
-    Ptr<Node> root = scene.shared_from_this();
-    Node* newHover = hitTestTopmost(root, worldPos);
+    Node* newHover = hitTestTopmost(&scene, worldPos);
 
     if (newHover != hoverTarget_) {
         if (hoverTarget_) {
@@ -0,0 +1,826 @@
+#include <easy2d/scene/scene_serializer.h>
+#include <easy2d/scene/sprite.h>
+#include <easy2d/scene/text.h>
+#include <easy2d/scene/shape_node.h>
+#include <easy2d/scene/transform_store.h>
+#include <easy2d/resource/resource_manager.h>
+#include <easy2d/utils/logger.h>
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace easy2d {
+
+// ============================================================================
+// 文件结构
+// ============================================================================
+namespace {
+
+constexpr uint32 SCENE_FILE_MAGIC = 0x43533245;  // "E2SC"
+constexpr uint32 NO_STRING = 0xFFFFFFFFu;
+constexpr uint32 NO_PARENT = 0xFFFFFFFFu;
+
+struct SceneFileHeader {
+    uint32 magic;
+    uint16 version;
+    uint16 recordSize;      // 单条 SceneNodeRecord 的字节数
+    uint32 nodeCount;
+    uint32 stringCount;
+    uint32 stringsOffset;
+    uint32 nodesOffset;
+    uint32 dataOffset;
+    uint32 dataSize;
+};
+
+// SceneNodeRecord::flags
+constexpr uint32 NODE_VISIBLE = 1u << 0;
+constexpr uint32 NODE_SPATIAL_INDEXED = 1u << 1;
+
+// 版本 1 的节点记录；新增字段只能追加在末尾
+struct SceneNodeRecord {
+    uint32 parent = NO_PARENT;
+    uint32 type = NO_STRING;
+    uint32 name = NO_STRING;
+    int32 tag = 0;
+    int32 zOrder = 0;
+    uint32 flags = NODE_VISIBLE | NODE_SPATIAL_INDEXED;
+    float position[2] = {0.0f, 0.0f};
+    float rotation = 0.0f;
+    float scale[2] = {1.0f, 1.0f};
+    float anchor[2] = {0.5f, 0.5f};
+    float skew[2] = {0.0f, 0.0f};
+    float opacity = 1.0f;
+    uint32 dataOffset = 0;
+    uint32 dataSize = 0;
+};
+
+inline size_t alignTo8(size_t value) {
+    return (value + 7) & ~size_t(7);
+}
+
+// ============================================================================
+// 只读内存映射文件
+// ============================================================================
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+        if (data_) munmap(const_cast<uint8*>(data_), size_);
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    bool open(const std::string& path) {
+#ifdef _WIN32
+        file_ = CreateFileW(std::filesystem::u8path(path).wstring().c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+            return false;
+        }
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) {
+            return false;
+        }
+        data_ = static_cast<const uint8*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd_, &st) != 0 || st.st_size == 0) {
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (mapped == MAP_FAILED) {
+            return false;
+        }
+        data_ = static_cast<const uint8*>(mapped);
+        size_ = static_cast<size_t>(st.st_size);
+#endif
+        return data_ != nullptr;
+    }
+
+    const uint8* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    const uint8* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// 节点类型注册表
+// ============================================================================
+struct NodeTypeRegistry {
+    std::deque<SceneNodeType> types;        // deque 追加时不移动已有元素，getNodeType 返回的引用长期有效
+    std::unordered_map<std::type_index, size_t> byType;
+    std::unordered_map<std::string, size_t> byName;
+    std::unordered_map<std::type_index, size_t> resolved;   // 未注册派生类 -> 匹配到的类型
+
+    void add(std::type_index type, SceneNodeType desc) {
+        auto it = byName.find(desc.name);
+        size_t index;
+        if (it != byName.end()) {
+            index = it->second;
+            types[index] = std::move(desc);
+        } else {
+            index = types.size();
+            byName.emplace(desc.name, index);
+            types.push_back(std::move(desc));
+        }
+        byType[type] = index;
+        resolved.clear();
+    }
+
+    const SceneNodeType& find(const Node& node) {
+        std::type_index type(typeid(node));
+        if (auto it = byType.find(type); it != byType.end()) {
+            return types[it->second];
+        }
+        if (auto it = resolved.find(type); it != resolved.end()) {
+            return types[it->second];
+        }
+
+        // 从后往前找：后注册的类型更具体（Node 总在最前，可匹配任何节点）
+        size_t index = 0;
+        for (size_t i = types.size(); i-- > 0;) {
+            if (types[i].matches && types[i].matches(node)) {
+                index = i;
+                break;
+            }
+        }
+        E2D_LOG_WARN("SceneSerializer: {} is not registered, saved as {}", type.name(), types[index].name);
+        resolved.emplace(type, index);
+        return types[index];
+    }
+
+    const SceneNodeType* find(std::string_view name) const {
+        auto it = byName.find(std::string(name));
+        return it != byName.end() ? &types[it->second] : nullptr;
+    }
+};
+
+void writeColor(SceneWriter& writer, const Color& color) {
+    writer.write(color.r);
+    writer.write(color.g);
+    writer.write(color.b);
+    writer.write(color.a);
+}
+
+Color readColor(SceneReader& reader) {
+    Color color;
+    color.r = reader.read<float>();
+    color.g = reader.read<float>();
+    color.b = reader.read<float>();
+    color.a = reader.read<float>();
+    return color;
+}
+
+void registerBuiltinTypes(NodeTypeRegistry& registry) {
+    SceneNodeType node;
+    node.name = "Node";
+    node.create = []() { return makePtr<Node>(); };
+    node.matches = [](const Node&) { return true; };
+    registry.add(std::type_index(typeid(Node)), std::move(node));
+
+    SceneNodeType scene;
+    scene.name = "Scene";
+    scene.create = []() -> Ptr<Node> { return makePtr<Scene>(); };
+    scene.matches = [](const Node& n) { return dynamic_cast<const Scene*>(&n) != nullptr; };
+    scene.save = [](const Node& n, SceneWriter& writer) {
+        const auto& s = static_cast<const Scene&>(n);
+        writeColor(writer, s.getBackgroundColor());
+        writer.write(s.getViewportSize().width);
+        writer.write(s.getViewportSize().height);
+    };
+    scene.load = [](Node& n, SceneReader& reader) {
+        auto& s = static_cast<Scene&>(n);
+        s.setBackgroundColor(readColor(reader));
+        float width = reader.read<float>();
+        float height = reader.read<float>();
+        s.setViewportSize(width, height);
+    };
+    scene.copy = [](const Node& from, Node& to) {
+        const auto& src = static_cast<const Scene&>(from);
+        auto& dst = static_cast<Scene&>(to);
+        dst.setBackgroundColor(src.getBackgroundColor());
+        dst.setViewportSize(src.getViewportSize());
+    };
+    registry.add(std::type_index(typeid(Scene)), std::move(scene));
+
+    SceneNodeType sprite;
+    sprite.name = "Sprite";
+    sprite.create = []() -> Ptr<Node> { return makePtr<Sprite>(); };
+    sprite.matches = [](const Node& n) { return dynamic_cast<const Sprite*>(&n) != nullptr; };
+    sprite.save = [](const Node& n, SceneWriter& writer) {
+        const auto& s = static_cast<const Sprite&>(n);
+        Rect rect = s.getTextureRect();
+        writer.writeTexture(s.getTexture());
+        writer.write(rect.origin.x);
+        writer.write(rect.origin.y);
+        writer.write(rect.size.width);
+        writer.write(rect.size.height);
+        writeColor(writer, s.getColor());
+        writer.write(static_cast<uint8>((s.isFlipX() ? 1 : 0) | (s.isFlipY() ? 2 : 0)));
+    };
+    sprite.load = [](Node& n, SceneReader& reader) {
+        auto& s = static_cast<Sprite&>(n);
+        s.setTexture(reader.readTexture());
+        Rect rect;
+        rect.origin.x = reader.read<float>();
+        rect.origin.y = reader.read<float>();
+        rect.size.width = reader.read<float>();
+        rect.size.height = reader.read<float>();
+        s.setTextureRect(rect);
+        s.setColor(readColor(reader));
+        uint8 flip = reader.read<uint8>();
+        s.setFlipX((flip & 1) != 0);
+        s.setFlipY((flip & 2) != 0);
+    };
+    sprite.copy = [](const Node& from, Node& to) {
+        const auto& src = static_cast<const Sprite&>(from);
+        auto& dst = static_cast<Sprite&>(to);
+        dst.setTexture(src.getTexture());
+        dst.setTextureRect(src.getTextureRect());
+        dst.setColor(src.getColor());
+        dst.setFlipX(src.isFlipX());
+        dst.setFlipY(src.isFlipY());
+    };
+    registry.add(std::type_index(typeid(Sprite)), std::move(sprite));
+
+    SceneNodeType text;
+    text.name = "Text";
+    text.create = []() -> Ptr<Node> { return makePtr<Text>(); };
+    text.matches = [](const Node& n) { return dynamic_cast<const Text*>(&n) != nullptr; };
+    text.save = [](const Node& n, SceneWriter& writer) {
+        const auto& t = static_cast<const Text&>(n);
+        writer.writeString(t.getText().toUtf8());
+        writer.writeFont(t.getFont());
+        writer.write(static_cast<int32>(t.getFont() ? t.getFontSize() : 0));
+        writeColor(writer, t.getTextColor());
+        writer.write(static_cast<uint8>(t.getAlignment()));
+    };
+    text.load = [](Node& n, SceneReader& reader) {
+        auto& t = static_cast<Text&>(n);
+        t.setText(String(std::string(reader.readString())));
+        t.setFont(reader.readFont());
+        t.setFontSize(reader.read<int32>());
+        t.setTextColor(readColor(reader));
+        t.setAlignment(static_cast<Text::Alignment>(reader.read<uint8>()));
+    };
+    text.copy = [](const Node& from, Node& to) {
+        const auto& src = static_cast<const Text&>(from);
+        auto& dst = static_cast<Text&>(to);
+        dst.setText(src.getText());
+        dst.setFont(src.getFont());
+        dst.setFontSize(src.getFont() ? src.getFontSize() : 0);
+        dst.setTextColor(src.getTextColor());
+        dst.setAlignment(src.getAlignment());
+    };
+    registry.add(std::type_index(typeid(Text)), std::move(text));
+
+    SceneNodeType shape;
+    shape.name = "ShapeNode";
+    shape.create = []() -> Ptr<Node> { return makePtr<ShapeNode>(); };
+    shape.matches = [](const Node& n) { return dynamic_cast<const ShapeNode*>(&n) != nullptr; };
+    shape.save = [](const Node& n, SceneWriter& writer) {
+        const auto& s = static_cast<const ShapeNode&>(n);
+        writer.write(static_cast<uint8>(s.getShapeType()));
+        writer.write(static_cast<uint8>(s.isFilled() ? 1 : 0));
+        writeColor(writer, s.getColor());
+        writer.write(s.getLineWidth());
+        writer.write(static_cast<int32>(s.getSegments()));
+        writer.write(static_cast<uint32>(s.getPoints().size()));
+        for (const Vec2& point : s.getPoints()) {
+            writer.write(point.x);
+            writer.write(point.y);
+        }
+    };
+    shape.load = [](Node& n, SceneReader& reader) {
+        auto& s = static_cast<ShapeNode&>(n);
+        s.setShapeType(static_cast<ShapeType>(reader.read<uint8>()));
+        s.setFilled(reader.read<uint8>() != 0);
+        s.setColor(readColor(reader));
+        s.setLineWidth(reader.read<float>());
+        s.setSegments(reader.read<int32>());
+        uint32 count = reader.read<uint32>();
+        std::vector<Vec2> points;
+        points.reserve(std::min<size_t>(count, reader.getRemaining() / (sizeof(float) * 2)));
+        for (uint32 i = 0; i < count && reader.isValid(); ++i) {
+            float x = reader.read<float>();
+            float y = reader.read<float>();
+            points.emplace_back(x, y);
+        }
+        s.setPoints(points);
+    };
+    shape.copy = [](const Node& from, Node& to) {
+        const auto& src = static_cast<const ShapeNode&>(from);
+        auto& dst = static_cast<ShapeNode&>(to);
+        dst.setShapeType(src.getShapeType());
+        dst.setFilled(src.isFilled());
+        dst.setColor(src.getColor());
+        dst.setLineWidth(src.getLineWidth());
+        dst.setSegments(src.getSegments());
+        dst.setPoints(src.getPoints());
+    };
+    registry.add(std::type_index(typeid(ShapeNode)), std::move(shape));
+}
+
+NodeTypeRegistry& registry() {
+    static NodeTypeRegistry instance = []() {
+        NodeTypeRegistry r;
+        registerBuiltinTypes(r);
+        return r;
+    }();
+    return instance;
+}
+
+} // namespace
+
+// ============================================================================
+// 保存/加载上下文
+// ============================================================================
+struct SceneSaveContext {
+    std::vector<char> chars;
+    std::vector<uint32> offsets{0};
+    std::unordered_map<std::string, uint32> ids;
+    std::unordered_map<const Texture*, uint32> textures;
+    std::unordered_map<const FontAtlas*, uint32> fonts;
+
+    uint32 intern(std::string_view str) {
+        auto it = ids.find(std::string(str));
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32 id = static_cast<uint32>(offsets.size() - 1);
+        chars.insert(chars.end(), str.begin(), str.end());
+        offsets.push_back(static_cast<uint32>(chars.size()));
+        ids.emplace(std::string(str), id);
+        return id;
+    }
+};
+
+struct SceneLoadContext {
+    const uint32* offsets = nullptr;
+    const char* chars = nullptr;
+    uint32 stringCount = 0;
+    uint32 charsSize = 0;
+    std::unordered_map<uint32, Ptr<Texture>> textures;
+    std::unordered_map<uint32, Ptr<FontAtlas>> fonts;
+
+    bool getString(uint32 index, std::string_view& out) const {
+        if (index >= stringCount) {
+            return false;
+        }
+        uint32 begin;
+        uint32 end;
+        std::memcpy(&begin, offsets + index, sizeof(uint32));
+        std::memcpy(&end, offsets + index + 1, sizeof(uint32));
+        if (begin > end || end > charsSize) {
+            return false;
+        }
+        out = std::string_view(chars + begin, end - begin);
+        return true;
+    }
+};
+
+// ============================================================================
+// SceneWriter / SceneReader
+// ============================================================================
+void SceneWriter::writeBytes(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+void SceneWriter::writeString(std::string_view str) {
+    write(context_.intern(str));
+}
+
+void SceneWriter::writeTexture(const Ptr<Texture>& texture) {
+    uint32 id = NO_STRING;
+    if (texture) {
+        auto it = context_.textures.find(texture.get());
+        if (it != context_.textures.end()) {
+            id = it->second;
+        } else {
+            std::string key = ResourceManager::getInstance().getTextureKey(texture.get());
+            if (key.empty()) {
+                E2D_LOG_WARN("SceneSerializer: texture not managed by ResourceManager, saved as empty");
+            } else {
+                id = context_.intern(key);
+            }
+            context_.textures.emplace(texture.get(), id);
+        }
+    }
+    write(id);
+}
+
+void SceneWriter::writeFont(const Ptr<FontAtlas>& font) {
+    uint32 id = NO_STRING;
+    if (font) {
+        auto it = context_.fonts.find(font.get());
+        if (it != context_.fonts.end()) {
+            id = it->second;
+        } else {
+            std::string key = ResourceManager::getInstance().getFontKey(font.get());
+            if (key.empty()) {
+                E2D_LOG_WARN("SceneSerializer: font not managed by ResourceManager, saved as empty");
+            } else {
+                id = context_.intern(key);
+            }
+            context_.fonts.emplace(font.get(), id);
+        }
+    }
+    write(id);
+}
+
+bool SceneReader::readBytes(void* out, size_t size) {
+    if (!valid_ || size > getRemaining()) {
+        valid_ = false;
+        if (out) {
+            std::memset(out, 0, size);
+        }
+        return false;
+    }
+    std::memcpy(out, cursor_, size);
+    cursor_ += size;
+    return true;
+}
+
+std::string_view SceneReader::readString() {
+    uint32 id = read<uint32>();
+    std::string_view str;
+    if (valid_ && !context_.getString(id, str)) {
+        valid_ = false;
+    }
+    return str;
+}
+
+Ptr<Texture> SceneReader::readTexture() {
+    uint32 id = read<uint32>();
+    if (!valid_ || id == NO_STRING) {
+        return nullptr;
+    }
+
+    auto it = context_.textures.find(id);
+    if (it != context_.textures.end()) {
+        return it->second;
+    }
+
+    std::string_view key;
+    Ptr<Texture> texture;
+    if (context_.getString(id, key)) {
+        texture = ResourceManager::getInstance().loadTexture(std::string(key));
+    } else {
+        valid_ = false;
+    }
+    context_.textures.emplace(id, texture);
+    return texture;
+}
+
+Ptr<FontAtlas> SceneReader::readFont() {
+    uint32 id = read<uint32>();
+    if (!valid_ || id == NO_STRING) {
+        return nullptr;
+    }
+
+    auto it = context_.fonts.find(id);
+    if (it != context_.fonts.end()) {
+        return it->second;
+    }
+
+    std::string_view key;
+    Ptr<FontAtlas> font;
+    if (context_.getString(id, key)) {
+        font = ResourceManager::getInstance().loadFontByKey(std::string(key));
+    } else {
+        valid_ = false;
+    }
+    context_.fonts.emplace(id, font);
+    return font;
+}
+
+// ============================================================================
+// SceneSerializer
+// ============================================================================
+void SceneSerializer::registerNodeType(std::type_index type, SceneNodeType desc) {
+    if (!desc.copy && desc.save && desc.load) {
+        desc.copy = [save = desc.save, load = desc.load](const Node& source, Node& target) {
+            copyThroughData(save, load, source, target);
+        };
+    }
+    registry().add(type, std::move(desc));
+}
+
+const SceneNodeType& SceneSerializer::getNodeType(const Node& node) {
+    return registry().find(node);
+}
+
+void SceneSerializer::copyThroughData(const Function<void(const Node&, SceneWriter&)>& save,
+                                      const Function<void(Node&, SceneReader&)>& load,
+                                      const Node& source, Node& target) {
+    // 写入内存后立即读回，资源引用经 ResourceManager 缓存解析，仍与源节点共享
+    SceneSaveContext saveContext;
+    std::vector<uint8> data;
+    SceneWriter writer(saveContext, data);
+    save(source, writer);
+
+    SceneLoadContext loadContext;
+    loadContext.offsets = saveContext.offsets.data();
+    loadContext.chars = saveContext.chars.data();
+    loadContext.stringCount = static_cast<uint32>(saveContext.offsets.size() - 1);
+    loadContext.charsSize = static_cast<uint32>(saveContext.chars.size());
+    SceneReader reader(loadContext, data.data(), data.data() + data.size());
+    load(target, reader);
+}
+
+bool SceneSerializer::save(const Node& root, const std::string& filepath) {
+    NodeTypeRegistry& types = registry();
+    SceneSaveContext context;
+    std::vector<SceneNodeRecord> records;
+    std::vector<uint8> data;
+
+    // 先序遍历：子节点按 getChildren 的顺序（zOrder 有序）逆序入栈，出栈即为原顺序
+    std::vector<std::pair<const Node*, uint32>> stack;
+    stack.emplace_back(&root, NO_PARENT);
+    while (!stack.empty()) {
+        auto [node, parent] = stack.back();
+        stack.pop_back();
+
+        const SceneNodeType& type = types.find(*node);
+        SceneNodeRecord record;
+        record.parent = parent;
+        record.type = context.intern(type.name);
+        record.name = node->getName().empty() ? NO_STRING : context.intern(node->getName());
+        record.tag = node->getTag();
+        record.zOrder = node->getZOrder();
+        record.flags = (node->isVisible() ? NODE_VISIBLE : 0) | (node->isSpatialIndexed() ? NODE_SPATIAL_INDEXED : 0);
+
+        Vec2 position = node->getPosition();
+        Vec2 scale = node->getScale();
+        Vec2 anchor = node->getAnchor();
+        Vec2 skew = node->getSkew();
+        record.position[0] = position.x;
+        record.position[1] = position.y;
+        record.rotation = node->getRotation();
+        record.scale[0] = scale.x;
+        record.scale[1] = scale.y;
+        record.anchor[0] = anchor.x;
+        record.anchor[1] = anchor.y;
+        record.skew[0] = skew.x;
+        record.skew[1] = skew.y;
+        record.opacity = node->getOpacity();
+
+        record.dataOffset = static_cast<uint32>(data.size());
+        if (type.save) {
+            SceneWriter writer(context, data);
+            type.save(*node, writer);
+        }
+        record.dataSize = static_cast<uint32>(data.size() - record.dataOffset);
+
+        uint32 index = static_cast<uint32>(records.size());
+        records.push_back(record);
+
+        const auto& children = node->getChildren();
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            stack.emplace_back(it->get(), index);
+        }
+    }
+
+    // 计算各段偏移
+    SceneFileHeader header{};
+    header.magic = SCENE_FILE_MAGIC;
+    header.version = VERSION;
+    header.recordSize = static_cast<uint16>(sizeof(SceneNodeRecord));
+    header.nodeCount = static_cast<uint32>(records.size());
+    header.stringCount = static_cast<uint32>(context.offsets.size() - 1);
+
+    size_t stringsOffset = alignTo8(sizeof(SceneFileHeader));
+    size_t stringsSize = context.offsets.size() * sizeof(uint32) + context.chars.size();
+    size_t nodesOffset = alignTo8(stringsOffset + stringsSize);
+    size_t dataOffset = alignTo8(nodesOffset + records.size() * sizeof(SceneNodeRecord));
+    size_t fileSize = dataOffset + data.size();
+    if (fileSize > 0xFFFFFFFFu) {
+        E2D_LOG_ERROR("SceneSerializer: scene too large to save: {}", filepath);
+        return false;
+    }
+    header.stringsOffset = static_cast<uint32>(stringsOffset);
+    header.nodesOffset = static_cast<uint32>(nodesOffset);
+    header.dataOffset = static_cast<uint32>(dataOffset);
+    header.dataSize = static_cast<uint32>(data.size());
+
+    std::vector<uint8> buffer(fileSize, 0);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + stringsOffset, context.offsets.data(), context.offsets.size() * sizeof(uint32));
+    if (!context.chars.empty()) {
+        std::memcpy(buffer.data() + stringsOffset + context.offsets.size() * sizeof(uint32),
+                    context.chars.data(), context.chars.size());
+    }
+    if (!records.empty()) {
+        std::memcpy(buffer.data() + nodesOffset, records.data(), records.size() * sizeof(SceneNodeRecord));
+    }
+    if (!data.empty()) {
+        std::memcpy(buffer.data() + dataOffset, data.data(), data.size());
+    }
+
+    // 先写临时文件再替换，避免中途退出留下损坏的场景文件
+    std::string tempPath = filepath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            E2D_LOG_ERROR("SceneSerializer: failed to open for writing: {}", filepath);
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            E2D_LOG_ERROR("SceneSerializer: failed to write: {}", filepath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filepath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        E2D_LOG_ERROR("SceneSerializer: failed to write: {}", filepath);
+        return false;
+    }
+
+    E2D_LOG_DEBUG("SceneSerializer: saved {} nodes to {}", records.size(), filepath);
+    return true;
+}
+
+Ptr<Node> SceneSerializer::load(const std::string& filepath) {
+    std::string fullPath = ResourceManager::getInstance().findResourcePath(filepath);
+    if (fullPath.empty()) {
+        E2D_LOG_ERROR("SceneSerializer: scene file not found: {}", filepath);
+        return nullptr;
+    }
+
+    MappedFile file;
+    if (!file.open(fullPath) || file.size() < sizeof(SceneFileHeader)) {
+        E2D_LOG_ERROR("SceneSerializer: failed to map scene file: {}", filepath);
+        return nullptr;
+    }
+
+    // 校验文件头与各段范围
+    const uint8* base = file.data();
+    const size_t size = file.size();
+    SceneFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != SCENE_FILE_MAGIC || header.version == 0 || header.version > VERSION) {
+        E2D_LOG_ERROR("SceneSerializer: unsupported scene file (version {}): {}", header.version, filepath);
+        return nullptr;
+    }
+    // 各段必须按 文件头、字符串表、节点记录、附加数据 的顺序排列且互不重叠；
+    // 字符串内容占据偏移表之后到节点段之前的全部空间（以 64 位计算，避免溢出）
+    const uint64 stringsSize = (static_cast<uint64>(header.stringCount) + 1) * sizeof(uint32);
+    const uint64 stringsEnd = header.stringsOffset + stringsSize;
+    const uint64 nodesEnd = header.nodesOffset + static_cast<uint64>(header.nodeCount) * header.recordSize;
+    const uint64 dataEnd = static_cast<uint64>(header.dataOffset) + header.dataSize;
+    if (header.nodeCount == 0 || header.recordSize < sizeof(uint32) * 2 ||
+        header.stringsOffset < sizeof(SceneFileHeader) || stringsEnd > header.nodesOffset ||
+        nodesEnd > header.dataOffset || dataEnd > size) {
+        E2D_LOG_ERROR("SceneSerializer: corrupted scene file: {}", filepath);
+        return nullptr;
+    }
+
+    SceneLoadContext context;
+    context.offsets = reinterpret_cast<const uint32*>(base + header.stringsOffset);
+    context.chars = reinterpret_cast<const char*>(base + stringsEnd);
+    context.stringCount = header.stringCount;
+    context.charsSize = static_cast<uint32>(header.nodesOffset - stringsEnd);
+    const uint8* nodeBase = base + header.nodesOffset;
+    const uint8* dataBase = base + header.dataOffset;
+    const size_t recordSize = std::min<size_t>(header.recordSize, sizeof(SceneNodeRecord));
+
+    // 批量创建：预留变换槽位，并预先统计每个节点的子节点数以一次性分配子节点列表
+    std::vector<uint32> childCounts(header.nodeCount, 0);
+    for (uint32 i = 1; i < header.nodeCount; ++i) {
+        uint32 parent;
+        std::memcpy(&parent, nodeBase + static_cast<size_t>(i) * header.recordSize, sizeof(uint32));
+        if (parent >= i) {
+            E2D_LOG_ERROR("SceneSerializer: corrupted node hierarchy: {}", filepath);
+            return nullptr;
+        }
+        childCounts[parent]++;
+    }
+    TransformStore::getInstance().reserve(header.nodeCount);
+
+    NodeTypeRegistry& types = registry();
+    // 按字符串下标缓存类型名的解析结果，每种类型只查一次注册表
+    std::vector<const SceneNodeType*> typeCache(header.stringCount, nullptr);
+    std::vector<uint8> typeResolved(header.stringCount, 0);
+    std::vector<Ptr<Node>> nodes(header.nodeCount);
+
+    for (uint32 i = 0; i < header.nodeCount; ++i) {
+        SceneNodeRecord record;
+        std::memcpy(&record, nodeBase + static_cast<size_t>(i) * header.recordSize, recordSize);
+
+        // 节点类型（同一类型名只解析一次）
+        const SceneNodeType* type = nullptr;
+        if (record.type < header.stringCount && typeResolved[record.type]) {
+            type = typeCache[record.type];
+        } else {
+            std::string_view typeName;
+            if (context.getString(record.type, typeName)) {
+                type = types.find(typeName);
+                typeCache[record.type] = type;
+                typeResolved[record.type] = 1;
+            }
+            if (!type) {
+                E2D_LOG_WARN("SceneSerializer: unknown node type '{}', loaded as Node", typeName);
+            }
+        }
+
+        Ptr<Node> node = type ? type->create() : makePtr<Node>();
+        std::string_view name;
+        if (record.name != NO_STRING && context.getString(record.name, name)) {
+            node->setName(NameId(name));
+        }
+        node->setTag(record.tag);
+        node->setZOrder(record.zOrder);
+        node->setPosition(record.position[0], record.position[1]);
+        node->setRotation(record.rotation);
+        node->setScale(record.scale[0], record.scale[1]);
+        node->setAnchor(record.anchor[0], record.anchor[1]);
+        node->setSkew(record.skew[0], record.skew[1]);
+        node->setOpacity(record.opacity);
+        node->setVisible((record.flags & NODE_VISIBLE) != 0);
+        node->setSpatialIndexed((record.flags & NODE_SPATIAL_INDEXED) != 0);
+
+        if (type && type->load && record.dataSize > 0) {
+            if (record.dataOffset > header.dataSize || record.dataSize > header.dataSize - record.dataOffset) {
+                E2D_LOG_ERROR("SceneSerializer: corrupted node data: {}", filepath);
+                return nullptr;
+            }
+            const uint8* begin = dataBase + record.dataOffset;
+            SceneReader reader(context, begin, begin + record.dataSize);
+            type->load(*node, reader);
+            if (!reader.isValid()) {
+                E2D_LOG_WARN("SceneSerializer: truncated data for node {} ({})", i, type->name);
+            }
+        }
+
+        node->reserveChildren(childCounts[i]);
+        if (i > 0) {
+            nodes[record.parent]->addChild(node);
+        }
+        nodes[i] = std::move(node);
+    }
+
+    E2D_LOG_DEBUG("SceneSerializer: loaded {} nodes from {}", header.nodeCount, filepath);
+    return nodes[0];
+}
+
+Ptr<Scene> SceneSerializer::loadScene(const std::string& filepath) {
+    Ptr<Node> root = load(filepath);
+    if (!root) {
+        return nullptr;
+    }
+    if (!dynamic_cast<Scene*>(root.get())) {
+        E2D_LOG_ERROR("SceneSerializer: root node is not a Scene: {}", filepath);
+        return nullptr;
+    }
+    return staticPtrCast<Scene>(root);
+}
+
+} // namespace easy2d
@@ -2,8 +2,6 @@
 #include <easy2d/graphics/render_backend.h>
 #include <easy2d/graphics/texture.h>
 #include <easy2d/graphics/render_command.h>
-#include <algorithm>
-#include <cmath>
 
 namespace easy2d {
 
@@ -52,48 +50,16 @@ Ptr<Sprite> Sprite::create(Ptr<Texture> texture, const Rect& rect) {
     return sprite;
 }
 
-Rect Sprite::getBoundingBox() const {
-    if (!texture_ || !texture_->isValid()) {
-        return Rect();
-    }
-
+Rect Sprite::getLocalRect() const {
+    // 锚点按内容尺寸偏移，缩放、旋转、斜切均由世界变换处理
     float width = textureRect_.width();
     float height = textureRect_.height();
-
-    auto pos = getPosition();
     auto anchor = getAnchor();
-    auto scale = getScale();
-
-    float w = width * scale.x;
-    float h = height * scale.y;
-    float x0 = pos.x - width * anchor.x * scale.x;
-    float y0 = pos.y - height * anchor.y * scale.y;
-    float x1 = x0 + w;
-    float y1 = y0 + h;
-
-    float l = std::min(x0, x1);
-    float t = std::min(y0, y1);
-    return Rect(l, t, std::abs(w), std::abs(h));
+    return Rect(-width * anchor.x, -height * anchor.y, width, height);
 }
 
-void Sprite::onDraw(RenderBackend& renderer) {
-    if (!texture_ || !texture_->isValid()) {
-        return;
-    }
-    
-    // Calculate destination rectangle based on texture rect
-    float width = textureRect_.width();
-    float height = textureRect_.height();
-    
-    auto pos = getPosition();
-    auto anchor = getAnchor();
-    auto scale = getScale();
-    Rect destRect(pos.x - width * anchor.x * scale.x, 
-                  pos.y - height * anchor.y * scale.y,
-                  width * scale.x, 
-                  height * scale.y);
-    
-    // Adjust source rect for flipping
+Rect Sprite::getSourceRect() const {
+    // 翻转通过负宽高表示
     Rect srcRect = textureRect_;
     if (flipX_) {
         srcRect.origin.x = srcRect.right();
@@ -103,49 +69,40 @@ void Sprite::onDraw(RenderBackend& renderer) {
         srcRect.origin.y = srcRect.bottom();
         srcRect.size.height = -srcRect.size.height;
     }
-    
-    renderer.drawSprite(*texture_, destRect, srcRect, color_, getRotation(), getAnchor());
+    return srcRect;
 }
 
-void Sprite::generateRenderCommand(std::vector<RenderCommand>& commands, int zOrder) {
+Rect Sprite::getBoundingBox() const {
     if (!texture_ || !texture_->isValid()) {
-        return;
+        return Rect();
     }
+    return getWorldTransform().transformRectBounds(getLocalRect());
+}
 
-    // 计算目标矩形（与 onDraw 一致）
-    float width = textureRect_.width();
-    float height = textureRect_.height();
-
-    auto pos = getPosition();
-    auto anchor = getAnchor();
-    auto scale = getScale();
-    Rect destRect(pos.x - width * anchor.x * scale.x,
-                  pos.y - height * anchor.y * scale.y,
-                  width * scale.x,
-                  height * scale.y);
-
-    // 调整源矩形（翻转）
-    Rect srcRect = textureRect_;
-    if (flipX_) {
-        srcRect.origin.x = srcRect.right();
-        srcRect.size.width = -srcRect.size.width;
+void Sprite::onDraw(RenderBackend& renderer) {
+    if (!texture_ || !texture_->isValid()) {
+        return;
     }
-    if (flipY_) {
-        srcRect.origin.y = srcRect.bottom();
-        srcRect.size.height = -srcRect.size.height;
+    renderer.drawSprite(*texture_, getLocalRect(), getSourceRect(), color_, getWorldTransform());
+}
+
+void Sprite::generateRenderCommand(std::vector<RenderCommand>& commands, int zOrder) {
+    if (!texture_ || !texture_->isValid()) {
+        return;
     }
 
-    // 创建渲染命令
+    // 创建渲染命令（目标矩形为局部空间，由世界变换定位）
     RenderCommand cmd;
     cmd.type = RenderCommandType::Sprite;
     cmd.zOrder = zOrder;
     cmd.data = SpriteData{
         texture_,
-        destRect,
-        srcRect,
+        getLocalRect(),
+        getSourceRect(),
         color_,
         getRotation(),
-        anchor
+        getAnchor(),
+        getWorldTransform()
     };
 
     commands.push_back(std::move(cmd));
@@ -1,6 +1,7 @@
 #include <easy2d/scene/text.h>
 #include <easy2d/graphics/render_backend.h>
 #include <easy2d/graphics/render_command.h>
+#include <algorithm>
 
 namespace easy2d {
 
@@ -10,20 +11,20 @@ Text::Text() {
 }
 
 Text::Text(const String& text) : text_(text) {
-    sizeDirty_ = true;
+    layoutDirty_ = true;
     // 文字默认锚点为左上角，这样setPosition(0, 0)会在左上角显示
     setAnchor(0.0f, 0.0f);
 }
 
 void Text::setText(const String& text) {
     text_ = text;
-    sizeDirty_ = true;
+    layoutDirty_ = true;
     updateSpatialIndex();
 }
 
 void Text::setFont(Ptr<FontAtlas> font) {
     font_ = font;
-    sizeDirty_ = true;
+    layoutDirty_ = true;
     updateSpatialIndex();
 }
 
@@ -33,11 +34,26 @@ void Text::setTextColor(const Color& color) {
 
 void Text::setFontSize(int size) {
     fontSize_ = size;
-    sizeDirty_ = true;
+    layoutDirty_ = true;
     updateSpatialIndex();
 }
 
+int Text::getFontSize() const {
+    if (fontSize_ > 0) {
+        return fontSize_;
+    }
+    return font_ ? font_->getFontSize() : 16;
+}
+
+float Text::getFontScale() const {
+    if (!font_ || !font_->isSDF() || fontSize_ <= 0 || font_->getFontSize() <= 0) {
+        return 1.0f;
+    }
+    return static_cast<float>(fontSize_) / static_cast<float>(font_->getFontSize());
+}
+
 void Text::setAlignment(Alignment align) {
+    // 对齐只影响整体原点，排版缓存无需重建
     alignment_ = align;
     updateSpatialIndex();
 }
@@ -49,18 +65,78 @@ Vec2 Text::getTextSize() const {
 
 float Text::getLineHeight() const {
     if (font_) {
-        return font_->getLineHeight();
+        return font_->getLineHeight() * getFontScale();
     }
-    return static_cast<float>(fontSize_);
+    return static_cast<float>(getFontSize());
 }
 
 void Text::updateCache() const {
-    if (!sizeDirty_ || !font_) {
+    if (!font_) {
         return;
     }
-    
-    cachedSize_ = font_->measureText(text_);
-    sizeDirty_ = false;
+    if (!layoutDirty_ && glyphRun_.generation == font_->getGeneration()) {
+        return;
+    }
+
+    // 排版字形四边形（相对文字左上角），同时计算尺寸
+    glyphRun_.clear();
+    float scale = getFontScale();
+    float ascent = font_->getAscent() * scale;
+    float lineHeight = font_->getLineHeight() * scale;
+    float width = 0.0f;
+    float height = (font_->getAscent() - font_->getDescent()) * scale;
+    float penX = 0.0f;
+    float lineY = 0.0f;
+
+    for (char32_t codepoint : text_.toUtf32()) {
+        if (codepoint == '\n') {
+            width = std::max(width, penX);
+            penX = 0.0f;
+            lineY += lineHeight;
+            height += lineHeight;
+            continue;
+        }
+
+        const Glyph* glyph = font_->getGlyph(codepoint);
+        if (!glyph) {
+            continue;
+        }
+        float glyphX = penX;
+        penX += glyph->advance * scale;
+        if (glyph->width <= 0.0f || glyph->height <= 0.0f) {
+            continue;
+        }
+
+        GlyphQuad quad;
+        quad.x = glyphX + glyph->bearingX * scale;
+        quad.y = lineY + ascent + glyph->bearingY * scale;
+        quad.w = glyph->width * scale;
+        quad.h = glyph->height * scale;
+        quad.u0 = glyph->u0;
+        quad.v0 = glyph->v0;
+        quad.u1 = glyph->u1;
+        quad.v1 = glyph->v1;
+        quad.page = glyph->page;
+        glyphRun_.quads.push_back(quad);
+        glyphRun_.codepoints.push_back(codepoint);
+        glyphRun_.pageMask |= 1u << glyph->page;
+    }
+
+    width = std::max(width, penX);
+    cachedSize_ = Vec2(width, height);
+    // 排版过程中缓存新字形可能淘汰其它页面，记录排版结束时的代数
+    glyphRun_.generation = font_->getGeneration();
+    layoutDirty_ = false;
+}
+
+Vec2 Text::getAlignedOrigin() const {
+    Vec2 pos = getPosition();
+    if (alignment_ == Alignment::Center) {
+        pos.x -= cachedSize_.x * 0.5f;
+    } else if (alignment_ == Alignment::Right) {
+        pos.x -= cachedSize_.x;
+    }
+    return pos;
 }
 
 Ptr<Text> Text::create() {
@@ -77,6 +153,13 @@ Ptr<Text> Text::create(const String& text, Ptr<FontAtlas> font) {
     return t;
 }
 
+Ptr<Text> Text::create(const String& text, Ptr<FontAtlas> font, int fontSize) {
+    auto t = makePtr<Text>(text);
+    t->setFont(font);
+    t->setFontSize(fontSize);
+    return t;
+}
+
 Rect Text::getBoundingBox() const {
     if (!font_ || text_.empty()) {
         return Rect();
@@ -88,16 +171,7 @@ Rect Text::getBoundingBox() const {
         return Rect();
     }
 
-    Vec2 pos = getPosition();
-
-    if (alignment_ != Alignment::Left) {
-        if (alignment_ == Alignment::Center) {
-            pos.x -= size.x * 0.5f;
-        } else if (alignment_ == Alignment::Right) {
-            pos.x -= size.x;
-        }
-    }
-
+    Vec2 pos = getAlignedOrigin();
     return Rect(pos.x, pos.y, size.x, size.y);
 }
 
@@ -106,19 +180,9 @@ void Text::onDraw(RenderBackend& renderer) {
         return;
     }
     
-    Vec2 pos = getPosition();
-    
-    // Calculate horizontal offset based on alignment
-    if (alignment_ != Alignment::Left) {
-        Vec2 size = getTextSize();
-        if (alignment_ == Alignment::Center) {
-            pos.x -= size.x * 0.5f;
-        } else if (alignment_ == Alignment::Right) {
-            pos.x -= size.x;
-        }
-    }
-
-    renderer.drawText(*font_, text_, pos, color_);
+    // 文字未变化时直接提交缓存的字形网格
+    updateCache();
+    renderer.drawGlyphRun(*font_, glyphRun_, getAlignedOrigin(), color_);
 }
 
 void Text::generateRenderCommand(std::vector<RenderCommand>& commands, int zOrder) {
@@ -126,17 +190,9 @@ void Text::generateRenderCommand(std::vector<RenderCommand>& commands, int zOrde
         return;
     }
 
-    Vec2 pos = getPosition();
-
     // 计算对齐偏移（与 onDraw 一致）
-    if (alignment_ != Alignment::Left) {
-        Vec2 size = getTextSize();
-        if (alignment_ == Alignment::Center) {
-            pos.x -= size.x * 0.5f;
-        } else if (alignment_ == Alignment::Right) {
-            pos.x -= size.x;
-        }
-    }
+    updateCache();
+    Vec2 pos = getAlignedOrigin();
 
     // 创建渲染命令
     RenderCommand cmd;
@@ -146,7 +202,8 @@ void Text::generateRenderCommand(std::vector<RenderCommand>& commands, int zOrde
         font_,
         text_,
         pos,
-        color_
+        color_,
+        getFontScale()
     };
 
     commands.push_back(std::move(cmd));
@@ -0,0 +1,409 @@
+#include <easy2d/scene/transform_store.h>
+#include <easy2d/scene/node.h>
+#include <algorithm>
+
+namespace easy2d {
+
+namespace {
+
+template <typename T>
+void appendCopy(std::vector<T>& values, uint32 index) {
+    // 先复制再追加：push_back 扩容时引用会失效
+    T value = values[index];
+    values.push_back(value);
+}
+
+}
+
+TransformStore& TransformStore::getInstance() {
+    // 有意不析构：静态对象（如 SceneManager）持有的节点可能在程序退出时晚于本单例释放
+    static TransformStore* instance = new TransformStore();
+    return *instance;
+}
+
+// ============================================================================
+// 槽位管理
+// ============================================================================
+uint32 TransformStore::allocate(Node* owner) {
+    // 新节点是根，放在任何位置都满足父先于子：优先复用空洞，否则追加
+    uint32 index;
+    if (!freeSlots_.empty()) {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        index = static_cast<uint32>(owners_.size());
+        owners_.emplace_back();
+        parents_.emplace_back();
+        firstChildren_.emplace_back();
+        lastChildren_.emplace_back();
+        nextSiblings_.emplace_back();
+        prevSiblings_.emplace_back();
+        positions_.emplace_back();
+        rotations_.emplace_back();
+        scales_.emplace_back();
+        skews_.emplace_back();
+        anchors_.emplace_back();
+        locals_.emplace_back();
+        worlds_.emplace_back();
+        localDirty_.emplace_back();
+        worldDirty_.emplace_back();
+    }
+
+    owners_[index] = owner;
+    parents_[index] = INVALID_INDEX;
+    firstChildren_[index] = INVALID_INDEX;
+    lastChildren_[index] = INVALID_INDEX;
+    nextSiblings_[index] = INVALID_INDEX;
+    prevSiblings_[index] = INVALID_INDEX;
+    positions_[index] = Vec2::Zero();
+    rotations_[index] = 0.0f;
+    scales_[index] = Vec2(1.0f, 1.0f);
+    skews_[index] = Vec2::Zero();
+    anchors_[index] = Vec2(0.5f, 0.5f);
+    localDirty_[index] = 1;
+    worldDirty_[index] = 1;
+    return index;
+}
+
+void TransformStore::reserve(size_t count) {
+    // 容量不足时至少翻倍，避免反复小量预留导致每次都整体重新分配
+    size_t capacity = owners_.size() + count;
+    if (capacity <= owners_.capacity()) {
+        return;
+    }
+    capacity = std::max(capacity, owners_.capacity() * 2);
+    owners_.reserve(capacity);
+    parents_.reserve(capacity);
+    firstChildren_.reserve(capacity);
+    lastChildren_.reserve(capacity);
+    nextSiblings_.reserve(capacity);
+    prevSiblings_.reserve(capacity);
+    positions_.reserve(capacity);
+    rotations_.reserve(capacity);
+    scales_.reserve(capacity);
+    skews_.reserve(capacity);
+    anchors_.reserve(capacity);
+    locals_.reserve(capacity);
+    worlds_.reserve(capacity);
+    localDirty_.reserve(capacity);
+    worldDirty_.reserve(capacity);
+}
+
+void TransformStore::release(uint32 index) {
+    // 节点析构前已移除全部子节点，这里仅防御性地把残留子节点变为根
+    uint32 child = firstChildren_[index];
+    while (child != INVALID_INDEX) {
+        uint32 next = nextSiblings_[child];
+        parents_[child] = INVALID_INDEX;
+        nextSiblings_[child] = INVALID_INDEX;
+        prevSiblings_[child] = INVALID_INDEX;
+        markSubtreeDirty(child);
+        child = next;
+    }
+    unlink(index);
+    clearSlot(index);
+    freeSlots_.push_back(index);
+}
+
+void TransformStore::setParent(uint32 index, uint32 parentIndex) {
+    if (parents_[index] == parentIndex) {
+        return;
+    }
+    unlink(index);
+    if (parentIndex != INVALID_INDEX) {
+        link(index, parentIndex);
+    }
+    markSubtreeDirty(index);
+
+    // 父节点在后面时只搬移这棵子树，其余节点下标不变
+    if (parentIndex != INVALID_INDEX && parentIndex > index) {
+        relocateSubtree(index);
+    }
+}
+
+void TransformStore::link(uint32 index, uint32 parentIndex) {
+    uint32 prev = lastChildren_[parentIndex];
+    parents_[index] = parentIndex;
+    prevSiblings_[index] = prev;
+    nextSiblings_[index] = INVALID_INDEX;
+    if (prev != INVALID_INDEX) {
+        nextSiblings_[prev] = index;
+    } else {
+        firstChildren_[parentIndex] = index;
+    }
+    lastChildren_[parentIndex] = index;
+}
+
+void TransformStore::unlink(uint32 index) {
+    uint32 parent = parents_[index];
+    if (parent == INVALID_INDEX) {
+        return;
+    }
+    uint32 prev = prevSiblings_[index];
+    uint32 next = nextSiblings_[index];
+    if (prev != INVALID_INDEX) {
+        nextSiblings_[prev] = next;
+    } else {
+        firstChildren_[parent] = next;
+    }
+    if (next != INVALID_INDEX) {
+        prevSiblings_[next] = prev;
+    } else {
+        lastChildren_[parent] = prev;
+    }
+    parents_[index] = INVALID_INDEX;
+    prevSiblings_[index] = INVALID_INDEX;
+    nextSiblings_[index] = INVALID_INDEX;
+}
+
+uint32 TransformStore::advance(uint32 index, uint32 root, bool descend) const {
+    if (descend && firstChildren_[index] != INVALID_INDEX) {
+        return firstChildren_[index];
+    }
+    while (index != root) {
+        if (nextSiblings_[index] != INVALID_INDEX) {
+            return nextSiblings_[index];
+        }
+        index = parents_[index];
+    }
+    return INVALID_INDEX;
+}
+
+void TransformStore::clearSlot(uint32 index) {
+    owners_[index] = nullptr;
+    parents_[index] = INVALID_INDEX;
+    firstChildren_[index] = INVALID_INDEX;
+    lastChildren_[index] = INVALID_INDEX;
+    nextSiblings_[index] = INVALID_INDEX;
+    prevSiblings_[index] = INVALID_INDEX;
+    localDirty_[index] = 0;
+    worldDirty_[index] = 0;
+}
+
+// ============================================================================
+// 变换属性
+// ============================================================================
+void TransformStore::setPosition(uint32 index, const Vec2& position) {
+    positions_[index] = position;
+    markDirty(index);
+}
+
+void TransformStore::setRotation(uint32 index, float rotation) {
+    rotations_[index] = rotation;
+    markDirty(index);
+}
+
+void TransformStore::setScale(uint32 index, const Vec2& scale) {
+    scales_[index] = scale;
+    markDirty(index);
+}
+
+void TransformStore::setSkew(uint32 index, const Vec2& skew) {
+    skews_[index] = skew;
+    markDirty(index);
+}
+
+void TransformStore::setAnchor(uint32 index, const Vec2& anchor) {
+    // 锚点只影响节点内容的摆放，不参与局部变换
+    anchors_[index] = anchor;
+}
+
+void TransformStore::markDirty(uint32 index) {
+    localDirty_[index] = 1;
+    markSubtreeDirty(index);
+}
+
+void TransformStore::markSubtreeDirty(uint32 index) {
+    if (worldDirty_[index]) {
+        return;
+    }
+    // 先序遍历子树；已脏节点的子树必然已脏，直接跳过
+    worldDirty_[index] = 1;
+    uint32 current = advance(index, index, true);
+    while (current != INVALID_INDEX) {
+        if (worldDirty_[current]) {
+            current = advance(current, index, false);
+        } else {
+            worldDirty_[current] = 1;
+            current = advance(current, index, true);
+        }
+    }
+}
+
+// ============================================================================
+// 变换矩阵
+// ============================================================================
+const Affine2D& TransformStore::getLocalTransform(uint32 index) {
+    if (localDirty_[index]) {
+        locals_[index] = Affine2D::fromTRSK(positions_[index], rotations_[index], scales_[index], skews_[index]);
+        localDirty_[index] = 0;
+    }
+    return locals_[index];
+}
+
+Affine2D TransformStore::getWorldTransform(uint32 index) {
+    if (worldDirty_[index]) {
+        computeWorld(index);
+    }
+    return worlds_[index];
+}
+
+void TransformStore::computeWorld(uint32 index) {
+    uint32 parent = parents_[index];
+    if (parent == INVALID_INDEX) {
+        worlds_[index] = getLocalTransform(index);
+    } else {
+        if (worldDirty_[parent]) {
+            computeWorld(parent);
+        }
+        Affine2D::multiply(worlds_[parent], getLocalTransform(index), worlds_[index]);
+    }
+    worldDirty_[index] = 0;
+}
+
+void TransformStore::updateWorldTransforms() {
+    if (needsCompaction()) {
+        compact();
+    }
+
+    // 父节点总在子节点之前，顺序遍历即可保证父节点的世界变换已是最新；空洞不为脏，直接跳过
+    const size_t count = owners_.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (!worldDirty_[i]) {
+            continue;
+        }
+        if (localDirty_[i]) {
+            locals_[i] = Affine2D::fromTRSK(positions_[i], rotations_[i], scales_[i], skews_[i]);
+            localDirty_[i] = 0;
+        }
+        uint32 parent = parents_[i];
+        if (parent == INVALID_INDEX) {
+            worlds_[i] = locals_[i];
+        } else {
+            Affine2D::multiply(worlds_[parent], locals_[i], worlds_[i]);
+        }
+        worldDirty_[i] = 0;
+    }
+}
+
+// ============================================================================
+// 子树搬移与压缩
+// ============================================================================
+void TransformStore::relocateSubtree(uint32 root) {
+    // 按先序逐个搬到尾部：父节点先搬，子节点随后追加，搬移后仍满足父先于子
+    scratch_.clear();
+    for (uint32 node = root; node != INVALID_INDEX; node = advance(node, root, true)) {
+        scratch_.push_back(node);
+    }
+    for (uint32 node : scratch_) {
+        moveSlot(node);
+    }
+}
+
+void TransformStore::moveSlot(uint32 from) {
+    uint32 to = static_cast<uint32>(owners_.size());
+    appendCopy(owners_, from);
+    appendCopy(parents_, from);
+    appendCopy(firstChildren_, from);
+    appendCopy(lastChildren_, from);
+    appendCopy(nextSiblings_, from);
+    appendCopy(prevSiblings_, from);
+    appendCopy(positions_, from);
+    appendCopy(rotations_, from);
+    appendCopy(scales_, from);
+    appendCopy(skews_, from);
+    appendCopy(anchors_, from);
+    appendCopy(locals_, from);
+    appendCopy(worlds_, from);
+    appendCopy(localDirty_, from);
+    appendCopy(worldDirty_, from);
+    owners_[to]->transformIndex_ = to;
+
+    // 把指向旧槽位的链接改到新槽位
+    uint32 parent = parents_[to];
+    uint32 prev = prevSiblings_[to];
+    uint32 next = nextSiblings_[to];
+    if (prev != INVALID_INDEX) {
+        nextSiblings_[prev] = to;
+    } else if (parent != INVALID_INDEX) {
+        firstChildren_[parent] = to;
+    }
+    if (next != INVALID_INDEX) {
+        prevSiblings_[next] = to;
+    } else if (parent != INVALID_INDEX) {
+        lastChildren_[parent] = to;
+    }
+    for (uint32 child = firstChildren_[to]; child != INVALID_INDEX; child = nextSiblings_[child]) {
+        parents_[child] = to;
+    }
+
+    clearSlot(from);
+    freeSlots_.push_back(from);
+}
+
+template <typename T>
+void TransformStore::permute(std::vector<T>& values, const std::vector<uint32>& order) {
+    // 保留原有容量：压缩后通常还会再创建同样多的节点
+    std::vector<T> sorted;
+    sorted.reserve(values.capacity());
+    for (uint32 oldIndex : order) {
+        sorted.push_back(values[oldIndex]);
+    }
+    values.swap(sorted);
+}
+
+void TransformStore::compact() {
+    const uint32 count = static_cast<uint32>(owners_.size());
+
+    // 从各根节点深度优先遍历得到新顺序，空洞被丢弃，子树重新连续
+    std::vector<uint32>& order = scratch_;
+    order.clear();
+    order.reserve(count - freeSlots_.size());
+    for (uint32 root = 0; root < count; ++root) {
+        if (!owners_[root] || parents_[root] != INVALID_INDEX) {
+            continue;
+        }
+        for (uint32 node = root; node != INVALID_INDEX; node = advance(node, root, true)) {
+            order.push_back(node);
+        }
+    }
+
+    std::vector<uint32> remap(count, INVALID_INDEX);
+    for (uint32 newIndex = 0; newIndex < order.size(); ++newIndex) {
+        remap[order[newIndex]] = newIndex;
+    }
+
+    permute(owners_, order);
+    permute(parents_, order);
+    permute(firstChildren_, order);
+    permute(lastChildren_, order);
+    permute(nextSiblings_, order);
+    permute(prevSiblings_, order);
+    permute(positions_, order);
+    permute(rotations_, order);
+    permute(scales_, order);
+    permute(skews_, order);
+    permute(anchors_, order);
+    permute(locals_, order);
+    permute(worlds_, order);
+    permute(localDirty_, order);
+    permute(worldDirty_, order);
+
+    auto fix = [&remap](uint32& index) {
+        if (index != INVALID_INDEX) {
+            index = remap[index];
+        }
+    };
+    const uint32 newCount = static_cast<uint32>(order.size());
+    for (uint32 i = 0; i < newCount; ++i) {
+        fix(parents_[i]);
+        fix(firstChildren_[i]);
+        fix(lastChildren_[i]);
+        fix(nextSiblings_[i]);
+        fix(prevSiblings_[i]);
+        owners_[i]->transformIndex_ = i;
+    }
+    freeSlots_.clear();
+}
+
+} // namespace easy2d
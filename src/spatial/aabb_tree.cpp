@@ -0,0 +1,624 @@
+#include <easy2d/spatial/aabb_tree.h>
+#include <easy2d/scene/node.h>
+#include <algorithm>
+
+namespace easy2d {
+
+namespace {
+
+// Rect::unionWith 会忽略零尺寸的矩形，这里点状对象同样需要参与合并
+inline Rect combine(const Rect& a, const Rect& b) {
+    float l = std::min(a.left(), b.left());
+    float t = std::min(a.top(), b.top());
+    float r = std::max(a.right(), b.right());
+    float btm = std::max(a.bottom(), b.bottom());
+    return Rect(l, t, r - l, btm - t);
+}
+
+inline float perimeter(const Rect& r) {
+    return 2.0f * (r.size.width + r.size.height);
+}
+
+inline Rect expand(const Rect& r, float margin) {
+    return Rect(r.origin.x - margin, r.origin.y - margin,
+                r.size.width + margin * 2.0f, r.size.height + margin * 2.0f);
+}
+
+} // namespace
+
+AABBTree::AABBTree(float fatMargin, float displacementMultiplier)
+    : fatMargin_(std::max(0.0f, fatMargin)),
+      displacementMultiplier_(std::max(0.0f, displacementMultiplier)) {}
+
+// ============================================================================
+// 节点分配
+// ============================================================================
+int32 AABBTree::allocateNode() {
+    int32 index;
+    if (freeList_ != INVALID) {
+        index = freeList_;
+        freeList_ = nodes_[index].parent;
+    } else {
+        index = static_cast<int32>(nodes_.size());
+        nodes_.emplace_back();
+    }
+    nodes_[index] = TreeNode{};
+    return index;
+}
+
+void AABBTree::freeNode(int32 index) {
+    TreeNode& node = nodes_[index];
+    node.object = nullptr;
+    node.child1 = INVALID;
+    node.child2 = INVALID;
+    node.height = -1;
+    node.parent = freeList_;
+    freeList_ = index;
+}
+
+Rect AABBTree::fatten(const Rect& bounds) const {
+    return expand(bounds, fatMargin_);
+}
+
+// ============================================================================
+// 插入 / 删除叶节点
+// ============================================================================
+void AABBTree::insertLeaf(int32 leaf) {
+    if (root_ == INVALID) {
+        root_ = leaf;
+        nodes_[leaf].parent = INVALID;
+        return;
+    }
+
+    // 沿代价最小的分支下降：在当前节点处新建父节点的代价与继续下降到子节点的代价比较，
+    // 下降时祖先包围盒扩大的部分计入继承代价
+    const Rect leafBox = nodes_[leaf].fat;
+    int32 index = root_;
+    while (!nodes_[index].isLeaf()) {
+        const TreeNode& node = nodes_[index];
+        float area = perimeter(node.fat);
+        float combinedArea = perimeter(combine(node.fat, leafBox));
+        float cost = 2.0f * combinedArea;
+        float inheritance = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32 child) {
+            const TreeNode& c = nodes_[child];
+            float enlarged = perimeter(combine(leafBox, c.fat));
+            return (c.isLeaf() ? enlarged : enlarged - perimeter(c.fat)) + inheritance;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32 sibling = index;
+    int32 oldParent = nodes_[sibling].parent;
+    int32 newParent = allocateNode();
+
+    TreeNode& parent = nodes_[newParent];
+    parent.parent = oldParent;
+    parent.fat = combine(leafBox, nodes_[sibling].fat);
+    parent.height = nodes_[sibling].height + 1;
+    parent.child1 = sibling;
+    parent.child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent != INVALID) {
+        if (nodes_[oldParent].child1 == sibling) {
+            nodes_[oldParent].child1 = newParent;
+        } else {
+            nodes_[oldParent].child2 = newParent;
+        }
+    } else {
+        root_ = newParent;
+    }
+
+    // 新父节点的包围盒与高度已经确定，旋转后从其父节点开始回溯
+    int32 top = balance(newParent);
+    refitAncestors(nodes_[top].parent);
+}
+
+void AABBTree::removeLeaf(int32 leaf) {
+    if (leaf == root_) {
+        root_ = INVALID;
+        return;
+    }
+
+    int32 parent = nodes_[leaf].parent;
+    int32 grandParent = nodes_[parent].parent;
+    int32 sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    // 兄弟节点顶替父节点的位置
+    if (grandParent != INVALID) {
+        if (nodes_[grandParent].child1 == parent) {
+            nodes_[grandParent].child1 = sibling;
+        } else {
+            nodes_[grandParent].child2 = sibling;
+        }
+        nodes_[sibling].parent = grandParent;
+        freeNode(parent);
+        refitAncestors(grandParent);
+    } else {
+        root_ = sibling;
+        nodes_[sibling].parent = INVALID;
+        freeNode(parent);
+    }
+    nodes_[leaf].parent = INVALID;
+}
+
+void AABBTree::refitAncestors(int32 index) {
+    while (index != INVALID) {
+        int32 top = balance(index);
+        TreeNode& node = nodes_[top];
+        const TreeNode& child1 = nodes_[node.child1];
+        const TreeNode& child2 = nodes_[node.child2];
+
+        Rect fat = combine(child1.fat, child2.fat);
+        int32 height = 1 + std::max(child1.height, child2.height);
+
+        // 包围盒与高度都没有变化时，更上层的祖先不受影响
+        bool changed = top != index || fat != node.fat || height != node.height;
+        node.fat = fat;
+        node.height = height;
+        if (!changed) {
+            break;
+        }
+        index = node.parent;
+    }
+}
+
+int32 AABBTree::balance(int32 iA) {
+    TreeNode* A = &nodes_[iA];
+    if (A->isLeaf() || A->height < 2) {
+        return iA;
+    }
+
+    int32 iB = A->child1;
+    int32 iC = A->child2;
+    TreeNode* B = &nodes_[iB];
+    TreeNode* C = &nodes_[iC];
+    int32 difference = C->height - B->height;
+
+    // C 比 B 高出 1 层以上：C 上旋
+    if (difference > 1) {
+        int32 iF = C->child1;
+        int32 iG = C->child2;
+        TreeNode* F = &nodes_[iF];
+        TreeNode* G = &nodes_[iG];
+
+        C->child1 = iA;
+        C->parent = A->parent;
+        A->parent = iC;
+        if (C->parent != INVALID) {
+            if (nodes_[C->parent].child1 == iA) {
+                nodes_[C->parent].child1 = iC;
+            } else {
+                nodes_[C->parent].child2 = iC;
+            }
+        } else {
+            root_ = iC;
+        }
+
+        // C 较高的子节点留在 C 下，较矮的交给 A
+        if (F->height > G->height) {
+            C->child2 = iF;
+            A->child2 = iG;
+            G->parent = iA;
+            A->fat = combine(B->fat, G->fat);
+            C->fat = combine(A->fat, F->fat);
+            A->height = 1 + std::max(B->height, G->height);
+            C->height = 1 + std::max(A->height, F->height);
+        } else {
+            C->child2 = iG;
+            A->child2 = iF;
+            F->parent = iA;
+            A->fat = combine(B->fat, F->fat);
+            C->fat = combine(A->fat, G->fat);
+            A->height = 1 + std::max(B->height, F->height);
+            C->height = 1 + std::max(A->height, G->height);
+        }
+        return iC;
+    }
+
+    // B 比 C 高出 1 层以上：B 上旋
+    if (difference < -1) {
+        int32 iD = B->child1;
+        int32 iE = B->child2;
+        TreeNode* D = &nodes_[iD];
+        TreeNode* E = &nodes_[iE];
+
+        B->child1 = iA;
+        B->parent = A->parent;
+        A->parent = iB;
+        if (B->parent != INVALID) {
+            if (nodes_[B->parent].child1 == iA) {
+                nodes_[B->parent].child1 = iB;
+            } else {
+                nodes_[B->parent].child2 = iB;
+            }
+        } else {
+            root_ = iB;
+        }
+
+        if (D->height > E->height) {
+            B->child2 = iD;
+            A->child1 = iE;
+            E->parent = iA;
+            A->fat = combine(C->fat, E->fat);
+            B->fat = combine(A->fat, D->fat);
+            A->height = 1 + std::max(C->height, E->height);
+            B->height = 1 + std::max(A->height, D->height);
+        } else {
+            B->child2 = iE;
+            A->child1 = iD;
+            D->parent = iA;
+            A->fat = combine(C->fat, D->fat);
+            B->fat = combine(A->fat, E->fat);
+            A->height = 1 + std::max(C->height, D->height);
+            B->height = 1 + std::max(A->height, E->height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+// ============================================================================
+// 插入 / 删除 / 更新
+// ============================================================================
+void AABBTree::insert(Node* node, const Rect& bounds) {
+    if (!node) return;
+    if (leaves_.count(node)) {
+        update(node, bounds);
+        return;
+    }
+
+    int32 leaf = allocateNode();
+    nodes_[leaf].object = node;
+    nodes_[leaf].bounds = bounds;
+    nodes_[leaf].fat = fatten(bounds);
+    leaves_[node] = leaf;
+    insertLeaf(leaf);
+}
+
+void AABBTree::remove(Node* node) {
+    if (!node) return;
+    auto it = leaves_.find(node);
+    if (it == leaves_.end()) return;
+
+    int32 leaf = it->second;
+    leaves_.erase(it);
+    removeLeaf(leaf);
+    freeNode(leaf);
+}
+
+void AABBTree::update(Node* node, const Rect& newBounds) {
+    if (!node) return;
+    auto it = leaves_.find(node);
+    if (it == leaves_.end()) {
+        insert(node, newBounds);
+        return;
+    }
+
+    int32 leaf = it->second;
+    TreeNode& current = nodes_[leaf];
+    Rect oldBounds = current.bounds;
+    current.bounds = newBounds;
+
+    // 沿位移方向预测外扩，持续移动的对象不必每帧重新插入
+    Rect fat = fatten(newBounds);
+    Vec2 displacement = (newBounds.origin - oldBounds.origin) * displacementMultiplier_;
+    if (displacement.x < 0.0f) {
+        fat.origin.x += displacement.x;
+    }
+    fat.size.width += std::abs(displacement.x);
+    if (displacement.y < 0.0f) {
+        fat.origin.y += displacement.y;
+    }
+    fat.size.height += std::abs(displacement.y);
+
+    // 仍在外扩包围盒内时无需调整结构；但对象明显缩小导致外扩盒过大时仍重新插入
+    if (current.fat.contains(newBounds) && expand(fat, fatMargin_ * 4.0f).contains(current.fat)) {
+        return;
+    }
+
+    removeLeaf(leaf);
+    nodes_[leaf].fat = fat;
+    insertLeaf(leaf);
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+template <typename Visitor>
+bool AABBTree::queryArea(const Rect& area, Visitor& visitor) const {
+    if (root_ == INVALID) {
+        return true;
+    }
+
+    int32 stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = root_;
+    while (top > 0) {
+        const TreeNode& node = nodes_[stack[--top]];
+        if (!node.fat.intersects(area)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (node.bounds.intersects(area) && !visitor(node.object)) {
+                return false;
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+    return true;
+}
+
+template <typename Visitor>
+bool AABBTree::queryPoint(const Vec2& point, Visitor& visitor) const {
+    if (root_ == INVALID) {
+        return true;
+    }
+
+    int32 stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = root_;
+    while (top > 0) {
+        const TreeNode& node = nodes_[stack[--top]];
+        if (!node.fat.containsPoint(point)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (node.bounds.containsPoint(point) && !visitor(node.object)) {
+                return false;
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+    return true;
+}
+
+void AABBTree::castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const {
+    if (root_ == INVALID) {
+        return;
+    }
+
+    // 栈中记录节点的进入参数；两个子节点中较近的后压栈、先弹出
+    struct Visit {
+        int32 node;
+        float t;
+    };
+    Visit stack[MAX_STACK];
+    int top = 0;
+    float rootT;
+    if (!ray.intersects(nodes_[root_].fat, maxT, rootT)) {
+        return;
+    }
+    stack[top++] = Visit{root_, rootT};
+    while (top > 0) {
+        Visit visit = stack[--top];
+        if (visit.t > maxT) {
+            continue;
+        }
+        const TreeNode& node = nodes_[visit.node];
+        if (node.isLeaf()) {
+            float t;
+            if (ray.intersects(node.bounds, maxT, t)) {
+                maxT = std::min(maxT, visitor(node.object, t));
+                if (maxT < 0.0f) {
+                    return;
+                }
+            }
+            continue;
+        }
+
+        float t1, t2;
+        bool hit1 = ray.intersects(nodes_[node.child1].fat, maxT, t1);
+        bool hit2 = ray.intersects(nodes_[node.child2].fat, maxT, t2);
+        if (hit1 && hit2) {
+            if (t1 <= t2) {
+                stack[top++] = Visit{node.child2, t2};
+                stack[top++] = Visit{node.child1, t1};
+            } else {
+                stack[top++] = Visit{node.child1, t1};
+                stack[top++] = Visit{node.child2, t2};
+            }
+        } else if (hit1) {
+            stack[top++] = Visit{node.child1, t1};
+        } else if (hit2) {
+            stack[top++] = Visit{node.child2, t2};
+        }
+    }
+}
+
+void AABBTree::queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const {
+    if (root_ == INVALID) {
+        return;
+    }
+
+    int32 stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = root_;
+    while (top > 0) {
+        const TreeNode& node = nodes_[stack[--top]];
+        if (!circleIntersects(node.fat, center, radius)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (circleIntersects(node.bounds, center, radius)) {
+                results.push_back(node.object);
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+void AABBTree::collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                              std::vector<SpatialNeighbor>& results) const {
+    if (root_ == INVALID) {
+        return;
+    }
+
+    // 深度优先的分支限界：两个子节点中较近的后压栈、先弹出
+    struct Visit {
+        int32 node;
+        float distance;
+    };
+    Visit stack[MAX_STACK];
+    int top = 0;
+    stack[top++] = Visit{root_, distanceSquared(nodes_[root_].fat, point)};
+
+    NearestCollector nearest(results, k, maxDistance);
+    while (top > 0) {
+        Visit visit = stack[--top];
+        if (visit.distance > nearest.boundSquared()) {
+            continue;
+        }
+        const TreeNode& node = nodes_[visit.node];
+        if (node.isLeaf()) {
+            float d = distanceSquared(node.bounds, point);
+            if (nearest.wants(d) && filter(node.object)) {
+                nearest.offer(node.object, d);
+            }
+            continue;
+        }
+
+        Visit first{node.child1, distanceSquared(nodes_[node.child1].fat, point)};
+        Visit second{node.child2, distanceSquared(nodes_[node.child2].fat, point)};
+        if (first.distance < second.distance) {
+            std::swap(first, second);
+        }
+        if (first.distance <= nearest.boundSquared()) {
+            stack[top++] = first;
+        }
+        if (second.distance <= nearest.boundSquared()) {
+            stack[top++] = second;
+        }
+    }
+    nearest.finish();
+}
+
+void AABBTree::query(const Rect& area, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryArea(area, collect);
+}
+
+void AABBTree::query(const Vec2& point, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryPoint(point, collect);
+}
+
+bool AABBTree::visit(const Rect& area, SpatialVisitor visitor) const {
+    return queryArea(area, visitor);
+}
+
+bool AABBTree::visit(const Vec2& point, SpatialVisitor visitor) const {
+    return queryPoint(point, visitor);
+}
+
+std::vector<std::pair<Node*, Node*>> AABBTree::queryCollisions() const {
+    std::vector<std::pair<Node*, Node*>> collisions;
+    if (root_ == INVALID) {
+        return collisions;
+    }
+
+    // 树与自身的双重遍历：(n, n) 表示子树内部的相交对，展开为两个子树各自的内部对
+    // 加上两子树之间的交叉对；交叉对只在包围盒相交时继续下降，每对只会访问一次
+    std::vector<std::pair<int32, int32>> stack;
+    stack.reserve(MAX_STACK);
+    stack.emplace_back(root_, root_);
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        const TreeNode& nodeA = nodes_[a];
+        const TreeNode& nodeB = nodes_[b];
+
+        if (a == b) {
+            if (!nodeA.isLeaf()) {
+                stack.emplace_back(nodeA.child1, nodeA.child1);
+                stack.emplace_back(nodeA.child2, nodeA.child2);
+                stack.emplace_back(nodeA.child1, nodeA.child2);
+            }
+            continue;
+        }
+
+        if (!nodeA.fat.intersects(nodeB.fat)) {
+            continue;
+        }
+        if (nodeA.isLeaf() && nodeB.isLeaf()) {
+            if (nodeA.bounds.intersects(nodeB.bounds)) {
+                collisions.emplace_back(nodeA.object, nodeB.object);
+            }
+        } else if (nodeB.isLeaf() || (!nodeA.isLeaf() && nodeA.height >= nodeB.height)) {
+            // 展开较高的一侧
+            stack.emplace_back(nodeA.child1, b);
+            stack.emplace_back(nodeA.child2, b);
+        } else {
+            stack.emplace_back(a, nodeB.child1);
+            stack.emplace_back(a, nodeB.child2);
+        }
+    }
+    return collisions;
+}
+
+// ============================================================================
+// 维护
+// ============================================================================
+void AABBTree::clear() {
+    nodes_.clear();
+    leaves_.clear();
+    root_ = INVALID;
+    freeList_ = INVALID;
+}
+
+size_t AABBTree::size() const {
+    return leaves_.size();
+}
+
+void AABBTree::forEachObject(SpatialObjectVisitor visitor) const {
+    for (const auto& [node, leaf] : leaves_) {
+        visitor(node, nodes_[leaf].bounds);
+    }
+}
+
+bool AABBTree::empty() const {
+    return leaves_.empty();
+}
+
+void AABBTree::rebuild() {
+    std::vector<std::pair<Node*, Rect>> allObjects;
+    allObjects.reserve(leaves_.size());
+    for (const auto& [object, leaf] : leaves_) {
+        allObjects.emplace_back(object, nodes_[leaf].bounds);
+    }
+
+    clear();
+    nodes_.reserve(allObjects.size() * 2);
+
+    for (const auto& [obj, bounds] : allObjects) {
+        insert(obj, bounds);
+    }
+}
+
+int AABBTree::getHeight() const {
+    return root_ == INVALID ? 0 : nodes_[root_].height;
+}
+
+}
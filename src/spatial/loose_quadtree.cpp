@@ -0,0 +1,595 @@
+#include <easy2d/spatial/loose_quadtree.h>
+#include <easy2d/scene/node.h>
+#include <algorithm>
+
+namespace easy2d {
+
+LooseQuadTree::LooseQuadTree(const Rect& worldBounds, float looseness, float minCellSize, int nodeCapacity)
+    : worldBounds_(worldBounds),
+      looseness_(std::clamp(looseness, 1.0f, 4.0f)),
+      maxDepth_(0),
+      nodeCapacity_(std::max(1, nodeCapacity)) {
+    // 最大深度随世界尺寸增长：格子边长不小于 minCellSize
+    float extent = std::max(worldBounds.size.width, worldBounds.size.height);
+    minCellSize = std::max(minCellSize, 1.0f);
+    while (maxDepth_ < MAX_DEPTH_LIMIT && extent * 0.5f >= minCellSize) {
+        extent *= 0.5f;
+        maxDepth_++;
+    }
+    resetRoot();
+}
+
+void LooseQuadTree::resetRoot() {
+    Cell root;
+    root.half = Vec2(worldBounds_.size.width * 0.5f, worldBounds_.size.height * 0.5f);
+    root.center = worldBounds_.origin + root.half;
+    Vec2 looseHalf = root.half * looseness_;
+    root.loose = Rect(root.center.x - looseHalf.x, root.center.y - looseHalf.y,
+                      looseHalf.x * 2.0f, looseHalf.y * 2.0f);
+    cells_.push_back(root);
+}
+
+// ============================================================================
+// 树节点与槽位分配
+// ============================================================================
+LooseQuadTree::Cell LooseQuadTree::makeChild(const Cell& parent, int32 parentIndex, int quadrant) const {
+    Cell child;
+    child.parent = parentIndex;
+    child.depth = parent.depth + 1;
+    child.half = parent.half * 0.5f;
+    child.center = Vec2(parent.center.x + ((quadrant & 1) ? child.half.x : -child.half.x),
+                        parent.center.y + ((quadrant & 2) ? child.half.y : -child.half.y));
+    Vec2 looseHalf = child.half * looseness_;
+    child.loose = Rect(child.center.x - looseHalf.x, child.center.y - looseHalf.y,
+                       looseHalf.x * 2.0f, looseHalf.y * 2.0f);
+    return child;
+}
+
+int LooseQuadTree::quadrantFor(const Cell& cell, const Rect& bounds) {
+    float x = bounds.origin.x + bounds.size.width * 0.5f;
+    float y = bounds.origin.y + bounds.size.height * 0.5f;
+    return (x >= cell.center.x ? 1 : 0) | (y >= cell.center.y ? 2 : 0);
+}
+
+int32 LooseQuadTree::findCell(int32 start, const Rect& bounds) const {
+    int32 index = start;
+    while (cells_[index].firstChild != INVALID) {
+        int32 child = cells_[index].firstChild + quadrantFor(cells_[index], bounds);
+        if (!cells_[child].loose.contains(bounds)) {
+            break;
+        }
+        index = child;
+    }
+    return index;
+}
+
+int32 LooseQuadTree::allocateElement() {
+    if (freeElement_ != INVALID) {
+        int32 index = freeElement_;
+        freeElement_ = elements_[index].next;
+        return index;
+    }
+    elements_.emplace_back();
+    return static_cast<int32>(elements_.size() - 1);
+}
+
+int32 LooseQuadTree::allocateChildren() {
+    if (freeCellBlock_ != INVALID) {
+        int32 index = freeCellBlock_;
+        freeCellBlock_ = cells_[index].firstChild;
+        freeCellCount_ -= 4;
+        return index;
+    }
+    int32 index = static_cast<int32>(cells_.size());
+    cells_.resize(cells_.size() + 4);
+    return index;
+}
+
+void LooseQuadTree::linkElement(int32 element, int32 cell) {
+    Element& e = elements_[element];
+    Cell& c = cells_[cell];
+    e.cell = cell;
+    e.prev = INVALID;
+    e.next = c.firstElement;
+    if (c.firstElement != INVALID) {
+        elements_[c.firstElement].prev = element;
+    }
+    c.firstElement = element;
+    c.count++;
+}
+
+void LooseQuadTree::unlinkElement(int32 element) {
+    Element& e = elements_[element];
+    Cell& c = cells_[e.cell];
+    if (e.prev != INVALID) {
+        elements_[e.prev].next = e.next;
+    } else {
+        c.firstElement = e.next;
+    }
+    if (e.next != INVALID) {
+        elements_[e.next].prev = e.prev;
+    }
+    c.count--;
+
+    // 叶节点清空后，父节点的四个子节点可能都已为空，登记为待合并
+    if (c.count == 0 && c.firstChild == INVALID && c.parent != INVALID && !cells_[c.parent].mergePending) {
+        cells_[c.parent].mergePending = true;
+        pendingMerges_.push_back(c.parent);
+    }
+    e.cell = INVALID;
+}
+
+// ============================================================================
+// 分裂与合并
+// ============================================================================
+void LooseQuadTree::split(int32 cell) {
+    // allocateChildren 可能使 cells_ 重新分配，之后再取引用
+    int32 first = allocateChildren();
+    for (int i = 0; i < 4; ++i) {
+        cells_[first + i] = makeChild(cells_[cell], cell, i);
+    }
+    cells_[cell].firstChild = first;
+
+    // 能完整落入子节点松散边界的对象下沉一层
+    int32 element = cells_[cell].firstElement;
+    while (element != INVALID) {
+        int32 next = elements_[element].next;
+        const Rect& bounds = elements_[element].bounds;
+        int32 child = first + quadrantFor(cells_[cell], bounds);
+        if (cells_[child].loose.contains(bounds)) {
+            unlinkElement(element);
+            linkElement(element, child);
+            relinkCount_++;
+        }
+        element = next;
+    }
+}
+
+void LooseQuadTree::maintain() {
+    mergePending();
+    if (relinkCount_ > lookup_.size() && relinkCount_ >= static_cast<size_t>(nodeCapacity_) * 4) {
+        compact();
+    }
+}
+
+void LooseQuadTree::mergePending() {
+    while (!pendingMerges_.empty()) {
+        int32 index = pendingMerges_.back();
+        pendingMerges_.pop_back();
+        cells_[index].mergePending = false;
+
+        int32 first = cells_[index].firstChild;
+        if (first == INVALID) {
+            continue;
+        }
+        bool empty = true;
+        for (int i = 0; i < 4; ++i) {
+            const Cell& child = cells_[first + i];
+            if (child.firstChild != INVALID || child.count != 0) {
+                empty = false;
+                break;
+            }
+        }
+        if (!empty) {
+            continue;
+        }
+
+        // 回收整个子节点块
+        cells_[first].firstChild = freeCellBlock_;
+        freeCellBlock_ = first;
+        freeCellCount_ += 4;
+
+        Cell& cell = cells_[index];
+        cell.firstChild = INVALID;
+        if (cell.count == 0 && cell.parent != INVALID && !cells_[cell.parent].mergePending) {
+            cells_[cell.parent].mergePending = true;
+            pendingMerges_.push_back(cell.parent);
+        }
+    }
+}
+
+// ============================================================================
+// 插入 / 删除 / 更新
+// ============================================================================
+void LooseQuadTree::insert(Node* node, const Rect& bounds) {
+    if (!node) return;
+    if (lookup_.count(node)) {
+        update(node, bounds);
+        return;
+    }
+
+    maintain();
+    int32 element = allocateElement();
+    elements_[element].object = node;
+    elements_[element].bounds = bounds;
+    lookup_[node] = element;
+
+    // 世界范围之外的对象留在根节点，根节点在查询时不做边界裁剪
+    int32 cell = findCell(0, bounds);
+    linkElement(element, cell);
+    relinkCount_++;
+
+    if (cells_[cell].firstChild == INVALID && cells_[cell].count > nodeCapacity_ &&
+        cells_[cell].depth < maxDepth_) {
+        split(cell);
+    }
+}
+
+void LooseQuadTree::remove(Node* node) {
+    if (!node) return;
+    auto it = lookup_.find(node);
+    if (it == lookup_.end()) return;
+
+    int32 element = it->second;
+    lookup_.erase(it);
+    unlinkElement(element);
+    elements_[element].object = nullptr;
+    elements_[element].next = freeElement_;
+    freeElement_ = element;
+    relinkCount_++;
+}
+
+void LooseQuadTree::update(Node* node, const Rect& newBounds) {
+    if (!node) return;
+    auto it = lookup_.find(node);
+    if (it == lookup_.end()) {
+        insert(node, newBounds);
+        return;
+    }
+
+    maintain();
+    int32 element = it->second;
+    int32 cell = elements_[element].cell;
+    elements_[element].bounds = newBounds;
+
+    // 仍在当前节点的松散边界内且不会下沉到子节点时原地更新
+    if ((cell == 0 || cells_[cell].loose.contains(newBounds)) && findCell(cell, newBounds) == cell) {
+        return;
+    }
+
+    // 否则从能容纳新边界的最近祖先开始重新定位（祖先的松散边界包含子节点的松散边界）
+    int32 target = cells_[cell].parent != INVALID ? cells_[cell].parent : cell;
+    while (target != 0 && !cells_[target].loose.contains(newBounds)) {
+        target = cells_[target].parent;
+    }
+    target = findCell(target, newBounds);
+
+    unlinkElement(element);
+    linkElement(element, target);
+    relinkCount_++;
+    if (cells_[target].firstChild == INVALID && cells_[target].count > nodeCapacity_ &&
+        cells_[target].depth < maxDepth_) {
+        split(target);
+    }
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+template <typename Visitor>
+bool LooseQuadTree::queryArea(const Rect& area, Visitor& visitor) const {
+    // 深度优先，每层最多压入 3 个尚未访问的兄弟节点。
+    // 松散边界完全落在查询区域内的子树，其中的对象必然相交，无需逐个测试
+    struct Visit {
+        int32 cell;
+        bool inside;
+    };
+    Visit stack[MAX_DEPTH_LIMIT * 3 + 4];
+    int top = 0;
+    stack[top++] = Visit{0, false};
+    while (top > 0) {
+        Visit visit = stack[--top];
+        const Cell& cell = cells_[visit.cell];
+        if (!visit.inside && cell.parent != INVALID) {
+            if (!cell.loose.intersects(area)) {
+                continue;
+            }
+            visit.inside = area.contains(cell.loose);
+        }
+        if (visit.inside) {
+            for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+                if (!visitor(elements_[e].object)) {
+                    return false;
+                }
+            }
+        } else {
+            for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+                if (elements_[e].bounds.intersects(area) && !visitor(elements_[e].object)) {
+                    return false;
+                }
+            }
+        }
+        if (cell.firstChild != INVALID) {
+            for (int i = 0; i < 4; ++i) {
+                stack[top++] = Visit{cell.firstChild + i, visit.inside};
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Visitor>
+bool LooseQuadTree::queryPoint(const Vec2& point, Visitor& visitor) const {
+    int32 stack[MAX_DEPTH_LIMIT * 3 + 4];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = cells_[stack[--top]];
+        if (cell.parent != INVALID && !cell.loose.containsPoint(point)) {
+            continue;
+        }
+        for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+            if (elements_[e].bounds.containsPoint(point) && !visitor(elements_[e].object)) {
+                return false;
+            }
+        }
+        if (cell.firstChild != INVALID) {
+            for (int i = 0; i < 4; ++i) {
+                stack[top++] = cell.firstChild + i;
+            }
+        }
+    }
+    return true;
+}
+
+void LooseQuadTree::query(const Rect& area, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryArea(area, collect);
+}
+
+void LooseQuadTree::query(const Vec2& point, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryPoint(point, collect);
+}
+
+bool LooseQuadTree::visit(const Rect& area, SpatialVisitor visitor) const {
+    return queryArea(area, visitor);
+}
+
+bool LooseQuadTree::visit(const Vec2& point, SpatialVisitor visitor) const {
+    return queryPoint(point, visitor);
+}
+
+void LooseQuadTree::castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const {
+    // 栈中记录子节点的进入参数，弹出时若已被更近的命中裁掉则跳过
+    struct Visit {
+        int32 cell;
+        float t;
+    };
+    Visit stack[MAX_DEPTH_LIMIT * 3 + 4];
+    int top = 0;
+    stack[top++] = Visit{0, 0.0f};
+    while (top > 0) {
+        Visit visit = stack[--top];
+        if (visit.t > maxT) {
+            continue;
+        }
+        const Cell& cell = cells_[visit.cell];
+        for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+            float t;
+            if (ray.intersects(elements_[e].bounds, maxT, t)) {
+                maxT = std::min(maxT, visitor(elements_[e].object, t));
+                if (maxT < 0.0f) {
+                    return;
+                }
+            }
+        }
+        if (cell.firstChild == INVALID) {
+            continue;
+        }
+
+        // 由远及近压栈，最近的子节点最先弹出
+        Visit order[4];
+        int count = 0;
+        for (int i = 0; i < 4; ++i) {
+            float t;
+            if (ray.intersects(cells_[cell.firstChild + i].loose, maxT, t)) {
+                int j = count++;
+                while (j > 0 && order[j - 1].t < t) {
+                    order[j] = order[j - 1];
+                    --j;
+                }
+                order[j] = Visit{cell.firstChild + i, t};
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            stack[top++] = order[i];
+        }
+    }
+}
+
+void LooseQuadTree::queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const {
+    int32 stack[MAX_DEPTH_LIMIT * 3 + 4];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Cell& cell = cells_[stack[--top]];
+        if (cell.parent != INVALID && !circleIntersects(cell.loose, center, radius)) {
+            continue;
+        }
+        for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+            if (circleIntersects(elements_[e].bounds, center, radius)) {
+                results.push_back(elements_[e].object);
+            }
+        }
+        if (cell.firstChild != INVALID) {
+            for (int i = 0; i < 4; ++i) {
+                stack[top++] = cell.firstChild + i;
+            }
+        }
+    }
+}
+
+void LooseQuadTree::collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                                   std::vector<SpatialNeighbor>& results) const {
+    // 深度优先的分支限界：较近的子节点先弹出，尽早收紧剪枝半径；
+    // 栈中记录节点距离，弹出时超过当前第 k 近的距离则跳过
+    struct Visit {
+        int32 cell;
+        float distance;
+    };
+    Visit stack[MAX_DEPTH_LIMIT * 3 + 4];
+    int top = 0;
+    stack[top++] = Visit{0, 0.0f};
+
+    NearestCollector nearest(results, k, maxDistance);
+    while (top > 0) {
+        Visit visit = stack[--top];
+        if (visit.distance > nearest.boundSquared()) {
+            continue;
+        }
+        const Cell& cell = cells_[visit.cell];
+        for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+            float d = distanceSquared(elements_[e].bounds, point);
+            if (nearest.wants(d) && filter(elements_[e].object)) {
+                nearest.offer(elements_[e].object, d);
+            }
+        }
+        if (cell.firstChild == INVALID) {
+            continue;
+        }
+
+        Visit order[4];
+        int count = 0;
+        for (int i = 0; i < 4; ++i) {
+            float d = distanceSquared(cells_[cell.firstChild + i].loose, point);
+            if (d <= nearest.boundSquared()) {
+                int j = count++;
+                while (j > 0 && order[j - 1].distance < d) {
+                    order[j] = order[j - 1];
+                    --j;
+                }
+                order[j] = Visit{cell.firstChild + i, d};
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            stack[top++] = order[i];
+        }
+    }
+    nearest.finish();
+}
+
+std::vector<std::pair<Node*, Node*>> LooseQuadTree::queryCollisions() const {
+    std::vector<std::pair<Node*, Node*>> collisions;
+
+    // 松散边界相互重叠，相交对象可能位于兄弟节点中：逐个对象查询，
+    // 只报告槽位下标更大的一方以去重
+    int32 stack[MAX_DEPTH_LIMIT * 3 + 4];
+    for (int32 i = 0; i < static_cast<int32>(elements_.size()); ++i) {
+        const Element& current = elements_[i];
+        if (!current.object) {
+            continue;
+        }
+
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Cell& cell = cells_[stack[--top]];
+            if (cell.parent != INVALID && !cell.loose.intersects(current.bounds)) {
+                continue;
+            }
+            for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+                if (e > i && elements_[e].bounds.intersects(current.bounds)) {
+                    collisions.emplace_back(current.object, elements_[e].object);
+                }
+            }
+            if (cell.firstChild != INVALID) {
+                for (int c = 0; c < 4; ++c) {
+                    stack[top++] = cell.firstChild + c;
+                }
+            }
+        }
+    }
+    return collisions;
+}
+
+// ============================================================================
+// 维护
+// ============================================================================
+void LooseQuadTree::clear() {
+    cells_.clear();
+    elements_.clear();
+    lookup_.clear();
+    pendingMerges_.clear();
+    freeCellBlock_ = INVALID;
+    freeElement_ = INVALID;
+    freeCellCount_ = 0;
+    relinkCount_ = 0;
+    resetRoot();
+}
+
+size_t LooseQuadTree::size() const {
+    return lookup_.size();
+}
+
+void LooseQuadTree::forEachObject(SpatialObjectVisitor visitor) const {
+    for (const Element& element : elements_) {
+        if (element.object) {
+            visitor(element.object, element.bounds);
+        }
+    }
+}
+
+bool LooseQuadTree::empty() const {
+    return lookup_.empty();
+}
+
+void LooseQuadTree::compact() {
+    // 按深度优先顺序重排对象槽位，使每个树节点的对象链表在内存中连续，查询时顺序访问
+    std::vector<Element> compacted;
+    compacted.reserve(lookup_.size());
+
+    std::vector<int32> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        Cell& cell = cells_[stack.back()];
+        stack.pop_back();
+
+        int32 first = static_cast<int32>(compacted.size());
+        for (int32 e = cell.firstElement; e != INVALID; e = elements_[e].next) {
+            int32 index = static_cast<int32>(compacted.size());
+            compacted.push_back(elements_[e]);
+            compacted.back().prev = index == first ? INVALID : index - 1;
+            compacted.back().next = index + 1;
+            lookup_[compacted.back().object] = index;
+        }
+        if (static_cast<int32>(compacted.size()) > first) {
+            compacted.back().next = INVALID;
+            cell.firstElement = first;
+        }
+        if (cell.firstChild != INVALID) {
+            for (int i = 3; i >= 0; --i) {
+                stack.push_back(cell.firstChild + i);
+            }
+        }
+    }
+
+    elements_.swap(compacted);
+    freeElement_ = INVALID;
+    relinkCount_ = 0;
+}
+
+void LooseQuadTree::rebuild() {
+    std::vector<std::pair<Node*, Rect>> allObjects;
+    allObjects.reserve(lookup_.size());
+    for (const Element& element : elements_) {
+        if (element.object) {
+            allObjects.emplace_back(element.object, element.bounds);
+        }
+    }
+
+    clear();
+
+    for (const auto& [obj, bounds] : allObjects) {
+        insert(obj, bounds);
+    }
+    compact();
+}
+
+}
@@ -5,8 +5,8 @@
 
 namespace easy2d {
 
-QuadTree::QuadTreeNode::QuadTreeNode(const Rect& bounds, int level)
-    : bounds(bounds), level(level) {}
+QuadTree::QuadTreeNode::QuadTreeNode(const Rect& bounds, int level, QuadTreeNode* parent)
+    : bounds(bounds), level(level), parent(parent) {}
 
 bool QuadTree::QuadTreeNode::contains(const Rect& rect) const {
     return bounds.contains(rect);
@@ -22,33 +22,45 @@ QuadTree::QuadTree(const Rect& worldBounds)
 }
 
 void QuadTree::insert(Node* node, const Rect& bounds) {
-    if (!node || !root_->intersects(bounds)) return;
+    if (!node) return;
+    if (locations_.count(node)) {
+        update(node, bounds);
+        return;
+    }
+    if (!root_->intersects(bounds)) return;
+
+    mergePending();
     insertIntoNode(root_.get(), node, bounds);
     objectCount_++;
 }
 
-void QuadTree::insertIntoNode(QuadTreeNode* node, Node* object, const Rect& bounds) {
-    if (node->children[0]) {
-        int index = -1;
-        float midX = node->bounds.origin.x + node->bounds.size.width / 2.0f;
-        float midY = node->bounds.origin.y + node->bounds.size.height / 2.0f;
+int QuadTree::childIndexFor(const QuadTreeNode* node, const Rect& bounds) {
+    float midX = node->bounds.origin.x + node->bounds.size.width / 2.0f;
+    float midY = node->bounds.origin.y + node->bounds.size.height / 2.0f;
 
-        bool top = bounds.origin.y + bounds.size.height <= midY;
-        bool bottom = bounds.origin.y >= midY;
-        bool left = bounds.origin.x + bounds.size.width <= midX;
-        bool right = bounds.origin.x >= midX;
+    bool top = bounds.origin.y + bounds.size.height <= midY;
+    bool bottom = bounds.origin.y >= midY;
+    bool left = bounds.origin.x + bounds.size.width <= midX;
+    bool right = bounds.origin.x >= midX;
 
-        if (top && left) index = 0;
-        else if (top && right) index = 1;
-        else if (bottom && left) index = 2;
-        else if (bottom && right) index = 3;
+    if (top && left) return 0;
+    if (top && right) return 1;
+    if (bottom && left) return 2;
+    if (bottom && right) return 3;
+    return -1;
+}
 
-        if (index != -1) {
-            insertIntoNode(node->children[index].get(), object, bounds);
-            return;
+void QuadTree::insertIntoNode(QuadTreeNode* node, Node* object, const Rect& bounds) {
+    // 伸出世界边界的对象留在根节点，子节点只保存被它完全包含的对象
+    while (node->children[0] && node->contains(bounds)) {
+        int index = childIndexFor(node, bounds);
+        if (index == -1) {
+            break;
         }
+        node = node->children[index].get();
     }
 
+    locations_[object] = Location{node, node->objects.size()};
     node->objects.emplace_back(object, bounds);
 
     if (node->objects.size() > MAX_OBJECTS && node->level < MAX_LEVELS) {
@@ -64,16 +76,16 @@ void QuadTree::split(QuadTreeNode* node) {
 
     node->children[0] = std::make_unique<QuadTreeNode>(
         Rect(node->bounds.origin.x, node->bounds.origin.y, node->bounds.size.width / 2.0f, node->bounds.size.height / 2.0f),
-        node->level + 1);
+        node->level + 1, node);
     node->children[1] = std::make_unique<QuadTreeNode>(
         Rect(midX, node->bounds.origin.y, node->bounds.size.width / 2.0f, node->bounds.size.height / 2.0f),
-        node->level + 1);
+        node->level + 1, node);
     node->children[2] = std::make_unique<QuadTreeNode>(
         Rect(node->bounds.origin.x, midY, node->bounds.size.width / 2.0f, node->bounds.size.height / 2.0f),
-        node->level + 1);
+        node->level + 1, node);
     node->children[3] = std::make_unique<QuadTreeNode>(
         Rect(midX, midY, node->bounds.size.width / 2.0f, node->bounds.size.height / 2.0f),
-        node->level + 1);
+        node->level + 1, node);
 
     auto objects = std::move(node->objects);
     node->objects.clear();
@@ -85,80 +97,273 @@ void QuadTree::split(QuadTreeNode* node) {
 
 void QuadTree::remove(Node* node) {
     if (!node) return;
-    if (removeFromNode(root_.get(), node)) {
-        objectCount_--;
-    }
+    auto it = locations_.find(node);
+    if (it == locations_.end()) return;
+
+    Location location = it->second;
+    locations_.erase(it);
+    eraseFromCell(location.cell, location.slot);
+    objectCount_--;
 }
 
-bool QuadTree::removeFromNode(QuadTreeNode* node, Node* object) {
-    auto it = std::find_if(node->objects.begin(), node->objects.end(),
-        [object](const auto& pair) { return pair.first == object; });
-    
-    if (it != node->objects.end()) {
-        node->objects.erase(it);
-        return true;
+void QuadTree::eraseFromCell(QuadTreeNode* cell, size_t slot) {
+    // 与末尾元素交换后弹出，并修正被交换对象的下标
+    auto& objects = cell->objects;
+    if (slot + 1 != objects.size()) {
+        objects[slot] = std::move(objects.back());
+        locations_[objects[slot].first].slot = slot;
     }
+    objects.pop_back();
 
-    if (node->children[0]) {
-        for (auto& child : node->children) {
-            if (removeFromNode(child.get(), object)) {
-                return true;
+    // 叶节点清空后，父节点的四个子节点可能都已为空，登记为待合并
+    if (objects.empty() && !cell->children[0] && cell->parent && !cell->parent->mergePending) {
+        cell->parent->mergePending = true;
+        pendingMerges_.push_back(cell->parent);
+    }
+}
+
+void QuadTree::mergePending() {
+    // 待合并节点一定还有子节点（只有合并自身才会删除其子节点），因此这里的指针都有效
+    while (!pendingMerges_.empty()) {
+        QuadTreeNode* node = pendingMerges_.back();
+        pendingMerges_.pop_back();
+        node->mergePending = false;
+
+        bool empty = node->children[0] != nullptr;
+        for (const auto& child : node->children) {
+            if (!child || child->children[0] || !child->objects.empty()) {
+                empty = false;
+                break;
             }
         }
-    }
+        if (!empty) {
+            continue;
+        }
 
-    return false;
+        for (auto& child : node->children) {
+            child.reset();
+        }
+        if (node->objects.empty() && node->parent && !node->parent->mergePending) {
+            node->parent->mergePending = true;
+            pendingMerges_.push_back(node->parent);
+        }
+    }
 }
 
 void QuadTree::update(Node* node, const Rect& newBounds) {
-    remove(node);
-    insert(node, newBounds);
+    if (!node) return;
+    auto it = locations_.find(node);
+    if (it == locations_.end()) {
+        insert(node, newBounds);
+        return;
+    }
+
+    mergePending();
+    Location location = it->second;
+    QuadTreeNode* cell = location.cell;
+
+    // 新边界仍属于当前树节点（且不会下沉到子节点）时原地更新
+    bool stillInside = cell == root_.get() ? root_->intersects(newBounds) : cell->contains(newBounds);
+    if (stillInside &&
+        (!cell->children[0] || childIndexFor(cell, newBounds) == -1)) {
+        cell->objects[location.slot].second = newBounds;
+        return;
+    }
+
+    // 否则从能容纳新边界的最近祖先开始重新插入，而不是从根节点
+    eraseFromCell(cell, location.slot);
+    QuadTreeNode* target = cell->parent ? cell->parent : cell;
+    while (target->parent && !target->contains(newBounds)) {
+        target = target->parent;
+    }
+    if (target == root_.get() && !root_->intersects(newBounds)) {
+        locations_.erase(it);
+        objectCount_--;
+        return;
+    }
+    insertIntoNode(target, node, newBounds);
 }
 
-std::vector<Node*> QuadTree::query(const Rect& area) const {
-    std::vector<Node*> results;
-    queryNode(root_.get(), area, results);
-    return results;
+template <typename Visitor>
+bool QuadTree::queryNode(const QuadTreeNode* node, const Rect& area, Visitor& visitor) {
+    if (!node || !node->intersects(area)) return true;
+
+    for (const auto& [obj, bounds] : node->objects) {
+        if (bounds.intersects(area) && !visitor(obj)) {
+            return false;
+        }
+    }
+
+    if (node->children[0]) {
+        for (const auto& child : node->children) {
+            if (!queryNode(child.get(), area, visitor)) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
-void QuadTree::queryNode(const QuadTreeNode* node, const Rect& area, std::vector<Node*>& results) const {
-    if (!node || !node->intersects(area)) return;
+template <typename Visitor>
+bool QuadTree::queryNode(const QuadTreeNode* node, const Vec2& point, Visitor& visitor) {
+    if (!node || !node->bounds.containsPoint(point)) return true;
 
     for (const auto& [obj, bounds] : node->objects) {
-        if (bounds.intersects(area)) {
-            results.push_back(obj);
+        if (bounds.containsPoint(point) && !visitor(obj)) {
+            return false;
         }
     }
 
     if (node->children[0]) {
         for (const auto& child : node->children) {
-            queryNode(child.get(), area, results);
+            if (!queryNode(child.get(), point, visitor)) {
+                return false;
+            }
         }
     }
+    return true;
+}
+
+void QuadTree::query(const Rect& area, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryNode(root_.get(), area, collect);
 }
 
-std::vector<Node*> QuadTree::query(const Vec2& point) const {
-    std::vector<Node*> results;
-    queryNode(root_.get(), point, results);
-    return results;
+void QuadTree::query(const Vec2& point, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryNode(root_.get(), point, collect);
 }
 
-void QuadTree::queryNode(const QuadTreeNode* node, const Vec2& point, std::vector<Node*>& results) const {
-    if (!node || !node->bounds.containsPoint(point)) return;
+bool QuadTree::visit(const Rect& area, SpatialVisitor visitor) const {
+    return queryNode(root_.get(), area, visitor);
+}
 
+bool QuadTree::visit(const Vec2& point, SpatialVisitor visitor) const {
+    return queryNode(root_.get(), point, visitor);
+}
+
+// 子节点在父节点中测试，根节点不裁剪（根上的对象可能伸出世界边界）
+bool QuadTree::castNode(const QuadTreeNode* node, const SpatialRay& ray, const Rect& sweep, float& maxT,
+                        SpatialRayVisitor& visitor) {
+    // 根节点和较高层的节点可能挂着大量对象，先用扫过区域的包围盒排除
     for (const auto& [obj, bounds] : node->objects) {
-        if (bounds.containsPoint(point)) {
-            results.push_back(obj);
+        float t;
+        if (sweep.intersects(bounds) && ray.intersects(bounds, maxT, t)) {
+            maxT = std::min(maxT, visitor(obj, t));
+            if (maxT < 0.0f) {
+                return false;
+            }
+        }
+    }
+    if (!node->children[0]) {
+        return true;
+    }
+
+    // 按进入参数由近及远访问子节点，较近的命中会裁掉更远的子树
+    struct Entry {
+        const QuadTreeNode* node;
+        float t;
+    };
+    Entry order[4];
+    int count = 0;
+    for (const auto& child : node->children) {
+        float t;
+        if (ray.intersects(child->bounds, maxT, t)) {
+            int i = count++;
+            while (i > 0 && order[i - 1].t > t) {
+                order[i] = order[i - 1];
+                --i;
+            }
+            order[i] = Entry{child.get(), t};
+        }
+    }
+    for (int i = 0; i < count && order[i].t <= maxT; ++i) {
+        if (!castNode(order[i].node, ray, sweep, maxT, visitor)) {
+            return false;
         }
     }
+    return true;
+}
+
+void QuadTree::castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const {
+    if (root_) {
+        castNode(root_.get(), ray, ray.bounds(maxT), maxT, visitor);
+    }
+}
 
+void QuadTree::queryCircleNode(const QuadTreeNode* node, const Vec2& center, float radius, std::vector<Node*>& results) {
+    for (const auto& [obj, bounds] : node->objects) {
+        if (circleIntersects(bounds, center, radius)) {
+            results.push_back(obj);
+        }
+    }
     if (node->children[0]) {
         for (const auto& child : node->children) {
-            queryNode(child.get(), point, results);
+            if (circleIntersects(child->bounds, center, radius)) {
+                queryCircleNode(child.get(), center, radius, results);
+            }
         }
     }
 }
 
+void QuadTree::queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const {
+    if (root_) {
+        queryCircleNode(root_.get(), center, radius, results);
+    }
+}
+
+void QuadTree::collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                              std::vector<SpatialNeighbor>& results) const {
+    if (!root_) {
+        return;
+    }
+
+    // 最优优先：每次展开离查询点最近的树节点，节点距离超过当前第 k 近的距离时结束。
+    // 队列中的节点互不相同，容量不超过满树的节点数
+    struct Entry {
+        const QuadTreeNode* node;
+        float distance;
+    };
+    auto fartherEntry = [](const Entry& a, const Entry& b) {
+        return a.distance > b.distance;
+    };
+    Entry queue[MAX_NODE_COUNT];
+    int size = 0;
+    queue[size++] = Entry{root_.get(), 0.0f};   // 根节点不裁剪（对象可能伸出世界边界）
+
+    NearestCollector nearest(results, k, maxDistance);
+    while (size > 0) {
+        std::pop_heap(queue, queue + size, fartherEntry);
+        Entry entry = queue[--size];
+        if (entry.distance > nearest.boundSquared()) {
+            break;
+        }
+
+        for (const auto& [obj, bounds] : entry.node->objects) {
+            float d = distanceSquared(bounds, point);
+            if (nearest.wants(d) && filter(obj)) {
+                nearest.offer(obj, d);
+            }
+        }
+        if (entry.node->children[0]) {
+            for (const auto& child : entry.node->children) {
+                float d = distanceSquared(child->bounds, point);
+                if (d <= nearest.boundSquared()) {
+                    queue[size++] = Entry{child.get(), d};
+                    std::push_heap(queue, queue + size, fartherEntry);
+                }
+            }
+        }
+    }
+    nearest.finish();
+}
+
 std::vector<std::pair<Node*, Node*>> QuadTree::queryCollisions() const {
     std::vector<std::pair<Node*, Node*>> collisions;
     collectCollisions(root_.get(), collisions);
@@ -208,34 +413,33 @@ void QuadTree::collectCollisions(const QuadTreeNode* node, std::vector<std::pair
 void QuadTree::clear() {
     root_ = std::make_unique<QuadTreeNode>(worldBounds_, 0);
     objectCount_ = 0;
+    locations_.clear();
+    pendingMerges_.clear();
 }
 
 size_t QuadTree::size() const {
     return objectCount_;
 }
 
+void QuadTree::forEachObject(SpatialObjectVisitor visitor) const {
+    for (const auto& [node, location] : locations_) {
+        visitor(node, location.cell->objects[location.slot].second);
+    }
+}
+
 bool QuadTree::empty() const {
     return objectCount_ == 0;
 }
 
 void QuadTree::rebuild() {
     std::vector<std::pair<Node*, Rect>> allObjects;
-    
-    std::function<void(QuadTreeNode*)> collect = [&](QuadTreeNode* node) {
-        if (!node) return;
-        for (const auto& obj : node->objects) {
-            allObjects.push_back(obj);
-        }
-        if (node->children[0]) {
-            for (auto& child : node->children) {
-                collect(child.get());
-            }
-        }
-    };
-    
-    collect(root_.get());
+    allObjects.reserve(locations_.size());
+    for (const auto& [object, location] : locations_) {
+        allObjects.push_back(location.cell->objects[location.slot]);
+    }
+
     clear();
-    
+
     for (const auto& [obj, bounds] : allObjects) {
         insert(obj, bounds);
     }
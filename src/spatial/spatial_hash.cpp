@@ -1,190 +1,688 @@
 #include <easy2d/spatial/spatial_hash.h>
 #include <easy2d/scene/node.h>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 
 namespace easy2d {
 
-SpatialHash::SpatialHash(float cellSize) : cellSize_(cellSize) {}
+namespace {
 
-SpatialHash::CellKey SpatialHash::getCellKey(float x, float y) const {
-    int64_t cellX = static_cast<int64_t>(std::floor(x / cellSize_));
-    int64_t cellY = static_cast<int64_t>(std::floor(y / cellSize_));
-    return {cellX, cellY};
+// 格子坐标的取值范围，留出余量使 max + 1 不会溢出
+constexpr float CELL_COORD_LIMIT = 1073741824.0f;
+
+constexpr size_t INITIAL_CAPACITY = 64;
+
+inline size_t mixHash(uint64 value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    return static_cast<size_t>(value);
+}
+
+} // namespace
+
+SpatialHash::SpatialHash(float cellSize)
+    : cellSize_(cellSize > 0 ? cellSize : 64.0f),
+      inverseCellSize_(1.0f / cellSize_) {}
+
+// ============================================================================
+// 格子坐标
+// ============================================================================
+SpatialHash::CellKey SpatialHash::packKey(int32 x, int32 y) {
+    return (static_cast<uint64>(static_cast<uint32>(x)) << 32) | static_cast<uint32>(y);
 }
 
-void SpatialHash::getCellsForRect(const Rect& rect, std::vector<CellKey>& cells) const {
-    cells.clear();
-    
-    CellKey minCell = getCellKey(rect.origin.x, rect.origin.y);
-    CellKey maxCell = getCellKey(rect.origin.x + rect.size.width, rect.origin.y + rect.size.height);
-    
-    for (int64_t x = minCell.first; x <= maxCell.first; ++x) {
-        for (int64_t y = minCell.second; y <= maxCell.second; ++y) {
-            cells.emplace_back(x, y);
+void SpatialHash::unpackKey(CellKey key, int32& x, int32& y) {
+    x = static_cast<int32>(static_cast<uint32>(key >> 32));
+    y = static_cast<int32>(static_cast<uint32>(key));
+}
+
+int32 SpatialHash::toCell(float value) const {
+    float cell = std::floor(value * inverseCellSize_);
+    return static_cast<int32>(std::clamp(cell, -CELL_COORD_LIMIT, CELL_COORD_LIMIT));
+}
+
+SpatialHash::CellRange SpatialHash::getCellRange(const Rect& rect) const {
+    return CellRange{toCell(rect.origin.x), toCell(rect.origin.y),
+                     toCell(rect.origin.x + rect.size.width), toCell(rect.origin.y + rect.size.height)};
+}
+
+// ============================================================================
+// 格子表（线性探测，负载不超过 1/2，删除时向后移位而不留墓碑）
+// ============================================================================
+const SpatialHash::CellSlot* SpatialHash::findCell(CellKey key) const {
+    if (cellSlots_.empty()) {
+        return nullptr;
+    }
+    size_t mask = cellSlots_.size() - 1;
+    for (size_t i = mixHash(key) & mask;; i = (i + 1) & mask) {
+        const CellSlot& slot = cellSlots_[i];
+        if (slot.count == 0) {
+            return nullptr;
+        }
+        if (slot.key == key) {
+            return &slot;
+        }
+    }
+}
+
+SpatialHash::CellSlot& SpatialHash::acquireCell(CellKey key) {
+    if ((cellCount_ + 1) * 2 > cellSlots_.size()) {
+        growCells();
+    }
+    size_t mask = cellSlots_.size() - 1;
+    for (size_t i = mixHash(key) & mask;; i = (i + 1) & mask) {
+        CellSlot& slot = cellSlots_[i];
+        if (slot.count == 0) {
+            slot.key = key;
+            slot.head = INVALID;
+            cellCount_++;
+            return slot;
+        }
+        if (slot.key == key) {
+            return slot;
         }
     }
 }
 
-void SpatialHash::insertIntoCells(Node* node, const Rect& bounds) {
-    std::vector<CellKey> cells;
-    getCellsForRect(bounds, cells);
-    
-    for (const auto& cell : cells) {
-        grid_[cell].insert(node);
+void SpatialHash::eraseCellSlot(size_t slot) {
+    size_t mask = cellSlots_.size() - 1;
+    size_t hole = slot;
+    for (size_t i = (hole + 1) & mask; cellSlots_[i].count != 0; i = (i + 1) & mask) {
+        // 理想位置不在 (hole, i] 之间的槽位前移填补空洞
+        size_t home = mixHash(cellSlots_[i].key) & mask;
+        bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            cellSlots_[hole] = cellSlots_[i];
+            hole = i;
+        }
     }
+    cellSlots_[hole] = CellSlot{};
+    cellCount_--;
 }
 
-void SpatialHash::removeFromCells(Node* node, const Rect& bounds) {
-    std::vector<CellKey> cells;
-    getCellsForRect(bounds, cells);
-    
-    for (const auto& cell : cells) {
-        auto it = grid_.find(cell);
-        if (it != grid_.end()) {
-            it->second.erase(node);
-            if (it->second.empty()) {
-                grid_.erase(it);
+void SpatialHash::growCells() {
+    std::vector<CellSlot> old = std::move(cellSlots_);
+    cellSlots_.assign(std::max(INITIAL_CAPACITY, old.size() * 2), CellSlot{});
+    size_t mask = cellSlots_.size() - 1;
+    for (const CellSlot& slot : old) {
+        if (slot.count == 0) {
+            continue;
+        }
+        size_t i = mixHash(slot.key) & mask;
+        while (cellSlots_[i].count != 0) {
+            i = (i + 1) & mask;
+        }
+        cellSlots_[i] = slot;
+    }
+}
+
+void SpatialHash::addToCells(uint32 object, const CellRange& range) {
+    for (int32 x = range.minX; x <= range.maxX; ++x) {
+        for (int32 y = range.minY; y <= range.maxY; ++y) {
+            int32 entry;
+            if (freeEntry_ != INVALID) {
+                entry = freeEntry_;
+                freeEntry_ = entries_[entry].next;
+            } else {
+                entry = static_cast<int32>(entries_.size());
+                entries_.emplace_back();
+            }
+
+            CellSlot& cell = acquireCell(packKey(x, y));
+            entries_[entry] = CellEntry{object, cell.head};
+            cell.head = entry;
+            cell.count++;
+        }
+    }
+}
+
+void SpatialHash::removeFromCells(uint32 object, const CellRange& range) {
+    for (int32 x = range.minX; x <= range.maxX; ++x) {
+        for (int32 y = range.minY; y <= range.maxY; ++y) {
+            CellSlot* cell = const_cast<CellSlot*>(findCell(packKey(x, y)));
+            if (!cell) {
+                continue;
+            }
+
+            int32* link = &cell->head;
+            while (*link != INVALID && entries_[*link].object != object) {
+                link = &entries_[*link].next;
+            }
+            if (*link == INVALID) {
+                continue;
+            }
+
+            int32 entry = *link;
+            *link = entries_[entry].next;
+            entries_[entry].next = freeEntry_;
+            freeEntry_ = entry;
+
+            if (--cell->count == 0) {
+                eraseCellSlot(static_cast<size_t>(cell - cellSlots_.data()));
             }
         }
     }
 }
 
+void SpatialHash::relabelInCells(uint32 from, uint32 to, const CellRange& range) {
+    for (int32 x = range.minX; x <= range.maxX; ++x) {
+        for (int32 y = range.minY; y <= range.maxY; ++y) {
+            const CellSlot* cell = findCell(packKey(x, y));
+            if (!cell) {
+                continue;
+            }
+            for (int32 e = cell->head; e != INVALID; e = entries_[e].next) {
+                if (entries_[e].object == from) {
+                    entries_[e].object = to;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// 对象表（Node* -> 稠密数组下标）
+// ============================================================================
+size_t SpatialHash::findObjectSlot(Node* node) const {
+    if (objectSlots_.empty()) {
+        return SIZE_MAX;
+    }
+    size_t mask = objectSlots_.size() - 1;
+    for (size_t i = mixHash(reinterpret_cast<uintptr_t>(node)) & mask;; i = (i + 1) & mask) {
+        uint32 value = objectSlots_[i];
+        if (value == 0) {
+            return SIZE_MAX;
+        }
+        if (objects_[value - 1].node == node) {
+            return i;
+        }
+    }
+}
+
+void SpatialHash::insertObjectSlot(uint32 object) {
+    if ((objects_.size() + 1) * 2 > objectSlots_.size()) {
+        growObjects();
+    }
+    size_t mask = objectSlots_.size() - 1;
+    size_t i = mixHash(reinterpret_cast<uintptr_t>(objects_[object].node)) & mask;
+    while (objectSlots_[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    objectSlots_[i] = object + 1;
+}
+
+void SpatialHash::eraseObjectSlot(size_t slot) {
+    size_t mask = objectSlots_.size() - 1;
+    size_t hole = slot;
+    for (size_t i = (hole + 1) & mask; objectSlots_[i] != 0; i = (i + 1) & mask) {
+        size_t home = mixHash(reinterpret_cast<uintptr_t>(objects_[objectSlots_[i] - 1].node)) & mask;
+        bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays) {
+            objectSlots_[hole] = objectSlots_[i];
+            hole = i;
+        }
+    }
+    objectSlots_[hole] = 0;
+}
+
+void SpatialHash::growObjects() {
+    std::vector<uint32> old = std::move(objectSlots_);
+    objectSlots_.assign(std::max(INITIAL_CAPACITY, old.size() * 2), 0);
+    size_t mask = objectSlots_.size() - 1;
+    for (uint32 value : old) {
+        if (value == 0) {
+            continue;
+        }
+        size_t i = mixHash(reinterpret_cast<uintptr_t>(objects_[value - 1].node)) & mask;
+        while (objectSlots_[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        objectSlots_[i] = value;
+    }
+}
+
+uint32 SpatialHash::nextStamp() const {
+    if (++queryStamp_ == 0) {
+        // 计数回绕：清空所有对象上的旧查询戳
+        for (const Object& object : objects_) {
+            object.stamp = 0;
+        }
+        queryStamp_ = 1;
+    }
+    return queryStamp_;
+}
+
+// ============================================================================
+// 插入 / 删除 / 更新
+// ============================================================================
 void SpatialHash::insert(Node* node, const Rect& bounds) {
     if (!node) return;
-    
-    insertIntoCells(node, bounds);
-    objectBounds_[node] = bounds;
-    objectCount_++;
+    if (findObjectSlot(node) != SIZE_MAX) {
+        update(node, bounds);
+        return;
+    }
+
+    uint32 index = static_cast<uint32>(objects_.size());
+    CellRange range = getCellRange(bounds);
+    objects_.push_back(Object{node, bounds, range, 0});
+    insertObjectSlot(index);
+    addToCells(index, range);
 }
 
 void SpatialHash::remove(Node* node) {
     if (!node) return;
-    
-    auto it = objectBounds_.find(node);
-    if (it != objectBounds_.end()) {
-        removeFromCells(node, it->second);
-        objectBounds_.erase(it);
-        objectCount_--;
+
+    size_t slot = findObjectSlot(node);
+    if (slot == SIZE_MAX) {
+        return;
     }
+    uint32 index = objectSlots_[slot] - 1;
+    removeFromCells(index, objects_[index].cells);
+    eraseObjectSlot(slot);
+
+    // 末尾对象移入空位，修正它在格子链表和对象表中的下标
+    uint32 last = static_cast<uint32>(objects_.size() - 1);
+    if (index != last) {
+        objects_[index] = objects_[last];
+        relabelInCells(last, index, objects_[index].cells);
+        objectSlots_[findObjectSlot(objects_[index].node)] = index + 1;
+    }
+    objects_.pop_back();
 }
 
 void SpatialHash::update(Node* node, const Rect& newBounds) {
-    auto it = objectBounds_.find(node);
-    if (it != objectBounds_.end()) {
-        removeFromCells(node, it->second);
-        insertIntoCells(node, newBounds);
-        it->second = newBounds;
-    }
-}
-
-std::vector<Node*> SpatialHash::query(const Rect& area) const {
-    std::vector<Node*> results;
-    std::unordered_set<Node*> found;
-    
-    std::vector<CellKey> cells;
-    getCellsForRect(area, cells);
-    
-    for (const auto& cell : cells) {
-        auto it = grid_.find(cell);
-        if (it != grid_.end()) {
-            for (Node* node : it->second) {
-                if (found.insert(node).second) {
-                    auto boundsIt = objectBounds_.find(node);
-                    if (boundsIt != objectBounds_.end() && boundsIt->second.intersects(area)) {
-                        results.push_back(node);
+    size_t slot = findObjectSlot(node);
+    if (slot == SIZE_MAX) {
+        insert(node, newBounds);
+        return;
+    }
+
+    uint32 index = objectSlots_[slot] - 1;
+    Object& object = objects_[index];
+    object.bounds = newBounds;
+
+    // 覆盖的格子不变时只需更新边界
+    CellRange range = getCellRange(newBounds);
+    if (range == object.cells) {
+        return;
+    }
+    removeFromCells(index, object.cells);
+    objects_[index].cells = range;
+    addToCells(index, range);
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+template <typename Visitor>
+bool SpatialHash::forEachCandidate(const CellRange& range, Visitor&& visitor) const {
+    if (objects_.empty()) {
+        return true;
+    }
+
+    uint32 stamp = nextStamp();
+    auto visitCell = [&](const CellSlot& cell) {
+        for (int32 e = cell.head; e != INVALID; e = entries_[e].next) {
+            const Object& object = objects_[entries_[e].object];
+            if (object.stamp == stamp) {
+                continue;
+            }
+            object.stamp = stamp;
+            if (!visitor(object)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // 查询覆盖的格子多于已占用的格子时，直接遍历格子表
+    uint64 spanX = static_cast<uint64>(static_cast<int64>(range.maxX) - range.minX + 1);
+    uint64 spanY = static_cast<uint64>(static_cast<int64>(range.maxY) - range.minY + 1);
+    uint64 span = spanX * spanY;
+    if (span > cellCount_) {
+        for (const CellSlot& cell : cellSlots_) {
+            if (cell.count == 0) {
+                continue;
+            }
+            int32 x, y;
+            unpackKey(cell.key, x, y);
+            if (x >= range.minX && x <= range.maxX && y >= range.minY && y <= range.maxY && !visitCell(cell)) {
+                return false;
+            }
+        }
+    } else {
+        for (int32 x = range.minX; x <= range.maxX; ++x) {
+            for (int32 y = range.minY; y <= range.maxY; ++y) {
+                const CellSlot* cell = findCell(packKey(x, y));
+                if (cell && !visitCell(*cell)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Visitor>
+bool SpatialHash::queryArea(const Rect& area, Visitor& visitor) const {
+    return forEachCandidate(getCellRange(area), [&](const Object& object) {
+        return !object.bounds.intersects(area) || visitor(object.node);
+    });
+}
+
+template <typename Visitor>
+bool SpatialHash::queryPoint(const Vec2& point, Visitor& visitor) const {
+    // 只涉及一个格子，无需去重
+    const CellSlot* cell = findCell(packKey(toCell(point.x), toCell(point.y)));
+    if (cell) {
+        for (int32 e = cell->head; e != INVALID; e = entries_[e].next) {
+            const Object& object = objects_[entries_[e].object];
+            if (object.bounds.containsPoint(point) && !visitor(object.node)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void SpatialHash::query(const Rect& area, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryArea(area, collect);
+}
+
+void SpatialHash::query(const Vec2& point, std::vector<Node*>& results) const {
+    auto collect = [&results](Node* node) {
+        results.push_back(node);
+        return true;
+    };
+    queryPoint(point, collect);
+}
+
+bool SpatialHash::visit(const Rect& area, SpatialVisitor visitor) const {
+    return queryArea(area, visitor);
+}
+
+bool SpatialHash::visit(const Vec2& point, SpatialVisitor visitor) const {
+    return queryPoint(point, visitor);
+}
+
+void SpatialHash::castRay(const SpatialRay& ray, float maxT, SpatialRayVisitor visitor) const {
+    if (objects_.empty() || !(maxT >= 0.0f)) {
+        return;
+    }
+
+    auto testObject = [&](const Object& object) {
+        float t;
+        if (ray.intersects(object.bounds, maxT, t)) {
+            maxT = std::min(maxT, visitor(object.node, t));
+        }
+        return maxT >= 0.0f;
+    };
+
+    // 扫过的盒子中心位于某个格子时，它接触的对象都登记在该格子周围 band 圈以内
+    int32 startX = toCell(ray.origin.x);
+    int32 startY = toCell(ray.origin.y);
+    int32 endX = toCell(ray.origin.x + ray.delta.x * maxT);
+    int32 endY = toCell(ray.origin.y + ray.delta.y * maxT);
+    float bandX = std::ceil(ray.extent.x * inverseCellSize_);
+    float bandY = std::ceil(ray.extent.y * inverseCellSize_);
+    double steps = std::abs(static_cast<double>(endX) - startX) + std::abs(static_cast<double>(endY) - startY) + 1.0;
+    double cost = steps * (2.0 * bandX + 1.0) * (2.0 * bandY + 1.0);
+
+    // 行进经过的格子比已占用的格子还多（长射线或粗扫掠）时，直接遍历格子表
+    if (cost > static_cast<double>(cellCount_)) {
+        const CellRange everything{static_cast<int32>(-CELL_COORD_LIMIT), static_cast<int32>(-CELL_COORD_LIMIT),
+                                   static_cast<int32>(CELL_COORD_LIMIT), static_cast<int32>(CELL_COORD_LIMIT)};
+        forEachCandidate(everything, testObject);
+        return;
+    }
+
+    // DDA：按格子边界的参数交替沿 x / y 前进，沿途访问每个格子及其 band 圈
+    const float infinity = std::numeric_limits<float>::infinity();
+    float cellX = ray.origin.x * inverseCellSize_;
+    float cellY = ray.origin.y * inverseCellSize_;
+    float dx = ray.delta.x * inverseCellSize_;
+    float dy = ray.delta.y * inverseCellSize_;
+    int32 stepX = dx > 0.0f ? 1 : (dx < 0.0f ? -1 : 0);
+    int32 stepY = dy > 0.0f ? 1 : (dy < 0.0f ? -1 : 0);
+    float nextX = stepX > 0 ? (static_cast<float>(startX) + 1.0f - cellX) / dx
+                : stepX < 0 ? (static_cast<float>(startX) - cellX) / dx : infinity;
+    float nextY = stepY > 0 ? (static_cast<float>(startY) + 1.0f - cellY) / dy
+                : stepY < 0 ? (static_cast<float>(startY) - cellY) / dy : infinity;
+    float stepTX = stepX != 0 ? 1.0f / std::abs(dx) : infinity;
+    float stepTY = stepY != 0 ? 1.0f / std::abs(dy) : infinity;
+    int32 rangeX = static_cast<int32>(bandX);
+    int32 rangeY = static_cast<int32>(bandY);
+
+    uint32 stamp = nextStamp();
+    auto visitCells = [&](int32 minX, int32 maxX, int32 minY, int32 maxY) {
+        for (int32 cx = minX; cx <= maxX; ++cx) {
+            for (int32 cy = minY; cy <= maxY; ++cy) {
+                const CellSlot* cell = findCell(packKey(cx, cy));
+                if (!cell) {
+                    continue;
+                }
+                for (int32 e = cell->head; e != INVALID; e = entries_[e].next) {
+                    const Object& object = objects_[entries_[e].object];
+                    if (object.stamp == stamp) {
+                        continue;
+                    }
+                    object.stamp = stamp;
+                    if (!testObject(object)) {
+                        return false;
                     }
                 }
             }
         }
+        return true;
+    };
+
+    // 首个格子访问整个 band 圈，之后每前进一格只多出前沿的一列或一行
+    int32 x = startX;
+    int32 y = startY;
+    if (!visitCells(x - rangeX, x + rangeX, y - rangeY, y + rangeY)) {
+        return;
+    }
+    while (x != endX || y != endY) {
+        float t;
+        bool stepAlongX = x != endX && (y == endY || nextX < nextY);
+        if (stepAlongX) {
+            t = nextX;
+            x += stepX;
+            nextX += stepTX;
+        } else {
+            t = nextY;
+            y += stepY;
+            nextY += stepTY;
+        }
+        // 之后的格子都比已知最近的命中更远
+        if (t > maxT) {
+            break;
+        }
+        bool visited = stepAlongX
+            ? visitCells(x + stepX * rangeX, x + stepX * rangeX, y - rangeY, y + rangeY)
+            : visitCells(x - rangeX, x + rangeX, y + stepY * rangeY, y + stepY * rangeY);
+        if (!visited) {
+            return;
+        }
     }
-    
-    return results;
 }
 
-std::vector<Node*> SpatialHash::query(const Vec2& point) const {
-    std::vector<Node*> results;
-    
-    CellKey cell = getCellKey(point.x, point.y);
-    auto it = grid_.find(cell);
-    
-    if (it != grid_.end()) {
-        for (Node* node : it->second) {
-            auto boundsIt = objectBounds_.find(node);
-            if (boundsIt != objectBounds_.end() && boundsIt->second.containsPoint(point)) {
-                results.push_back(node);
+void SpatialHash::queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const {
+    Rect area(center.x - radius, center.y - radius, radius * 2.0f, radius * 2.0f);
+    forEachCandidate(getCellRange(area), [&](const Object& object) {
+        if (circleIntersects(object.bounds, center, radius)) {
+            results.push_back(object.node);
+        }
+        return true;
+    });
+}
+
+void SpatialHash::collectNearest(const Vec2& point, size_t k, float maxDistance, SpatialFilter filter,
+                                 std::vector<SpatialNeighbor>& results) const {
+    if (objects_.empty()) {
+        return;
+    }
+
+    NearestCollector nearest(results, k, maxDistance);
+    uint32 stamp = 0;
+    auto visitCell = [&](int32 x, int32 y, const CellSlot& cell) {
+        Rect cellRect(static_cast<float>(x) * cellSize_, static_cast<float>(y) * cellSize_, cellSize_, cellSize_);
+        if (distanceSquared(cellRect, point) > nearest.boundSquared()) {
+            return;
+        }
+        for (int32 e = cell.head; e != INVALID; e = entries_[e].next) {
+            const Object& object = objects_[entries_[e].object];
+            if (object.stamp == stamp) {
+                continue;
+            }
+            object.stamp = stamp;
+            float d = distanceSquared(object.bounds, point);
+            if (nearest.wants(d) && filter(object.node)) {
+                nearest.offer(object.node, d);
+            }
+        }
+    };
+    auto visitAt = [&](int32 x, int32 y) {
+        if (const CellSlot* cell = findCell(packKey(x, y))) {
+            visitCell(x, y, *cell);
+        }
+    };
+
+    // 半径查询不需要由近及远，直接遍历覆盖圆的格子
+    if (k == std::numeric_limits<size_t>::max()) {
+        Rect area(point.x - maxDistance, point.y - maxDistance, maxDistance * 2.0f, maxDistance * 2.0f);
+        forEachCandidate(getCellRange(area), [&](const Object& object) {
+            float d = distanceSquared(object.bounds, point);
+            if (nearest.wants(d) && filter(object.node)) {
+                nearest.offer(object.node, d);
             }
+            return true;
+        });
+        nearest.finish();
+        return;
+    }
+
+    // 从查询点所在的格子开始逐圈向外扩展，直到已访问范围之外不可能有更近的对象
+    stamp = nextStamp();
+    int32 centerX = toCell(point.x);
+    int32 centerY = toCell(point.y);
+    for (int32 r = 0;; ++r) {
+        // 已扩展的范围超过已占用的格子数时，剩余部分直接遍历格子表（访问过的对象按查询戳跳过）
+        uint64 side = 2 * static_cast<uint64>(r) + 1;
+        if (side * side > cellCount_) {
+            for (const CellSlot& cell : cellSlots_) {
+                if (cell.count != 0) {
+                    int32 x, y;
+                    unpackKey(cell.key, x, y);
+                    visitCell(x, y, cell);
+                }
+            }
+            break;
+        }
+
+        if (r == 0) {
+            visitAt(centerX, centerY);
+        } else {
+            for (int32 x = centerX - r; x <= centerX + r; ++x) {
+                visitAt(x, centerY - r);
+                visitAt(x, centerY + r);
+            }
+            for (int32 y = centerY - r + 1; y <= centerY + r - 1; ++y) {
+                visitAt(centerX - r, y);
+                visitAt(centerX + r, y);
+            }
+        }
+
+        // 已访问的正方形之外的对象，离查询点至少是点到正方形边界的距离
+        float reach = std::min(std::min(point.x - static_cast<float>(centerX - r) * cellSize_,
+                                        static_cast<float>(centerX + r + 1) * cellSize_ - point.x),
+                               std::min(point.y - static_cast<float>(centerY - r) * cellSize_,
+                                        static_cast<float>(centerY + r + 1) * cellSize_ - point.y));
+        if (reach * reach > nearest.boundSquared()) {
+            break;
         }
     }
-    
-    return results;
+    nearest.finish();
 }
 
 std::vector<std::pair<Node*, Node*>> SpatialHash::queryCollisions() const {
     std::vector<std::pair<Node*, Node*>> collisions;
-    struct PairHash {
-        size_t operator()(const std::pair<Node*, Node*>& p) const noexcept {
-            auto a = reinterpret_cast<std::uintptr_t>(p.first);
-            auto b = reinterpret_cast<std::uintptr_t>(p.second);
-            return std::hash<std::uintptr_t>{}(a) ^ (std::hash<std::uintptr_t>{}(b) << 1);
+
+    // 一对相交对象可能同时出现在多个格子中，只在两者共同覆盖的第一个格子
+    // （两者最小格子坐标的较大值）中报告
+    for (const CellSlot& cell : cellSlots_) {
+        if (cell.count < 2) {
+            continue;
         }
-    };
-    auto makeOrdered = [](Node* a, Node* b) -> std::pair<Node*, Node*> {
-        return a < b ? std::make_pair(a, b) : std::make_pair(b, a);
-    };
+        int32 x, y;
+        unpackKey(cell.key, x, y);
 
-    std::unordered_set<std::pair<Node*, Node*>, PairHash> seen;
-    seen.reserve(objectCount_ * 2);
-    
-    for (const auto& [cell, objects] : grid_) {
-        std::vector<Node*> cellObjects(objects.begin(), objects.end());
-        
-        for (size_t i = 0; i < cellObjects.size(); ++i) {
-            auto bounds1 = objectBounds_.find(cellObjects[i]);
-            if (bounds1 == objectBounds_.end()) continue;
-            
-            for (size_t j = i + 1; j < cellObjects.size(); ++j) {
-                auto bounds2 = objectBounds_.find(cellObjects[j]);
-                if (bounds2 == objectBounds_.end()) continue;
-                
-                if (bounds1->second.intersects(bounds2->second)) {
-                    auto key = makeOrdered(cellObjects[i], cellObjects[j]);
-                    if (seen.insert(key).second) {
-                        collisions.emplace_back(key.first, key.second);
-                    }
+        for (int32 a = cell.head; a != INVALID; a = entries_[a].next) {
+            const Object& first = objects_[entries_[a].object];
+            for (int32 b = entries_[a].next; b != INVALID; b = entries_[b].next) {
+                const Object& second = objects_[entries_[b].object];
+                if (!first.bounds.intersects(second.bounds)) {
+                    continue;
+                }
+                if (std::max(first.cells.minX, second.cells.minX) == x &&
+                    std::max(first.cells.minY, second.cells.minY) == y) {
+                    collisions.emplace_back(first.node, second.node);
                 }
             }
         }
     }
-    
+
     return collisions;
 }
 
+// ============================================================================
+// 维护
+// ============================================================================
 void SpatialHash::clear() {
-    grid_.clear();
-    objectBounds_.clear();
-    objectCount_ = 0;
+    objects_.clear();
+    objectSlots_.clear();
+    cellSlots_.clear();
+    cellCount_ = 0;
+    entries_.clear();
+    freeEntry_ = INVALID;
 }
 
 size_t SpatialHash::size() const {
-    return objectCount_;
+    return objects_.size();
+}
+
+void SpatialHash::forEachObject(SpatialObjectVisitor visitor) const {
+    for (const Object& object : objects_) {
+        visitor(object.node, object.bounds);
+    }
 }
 
 bool SpatialHash::empty() const {
-    return objectCount_ == 0;
+    return objects_.empty();
 }
 
 void SpatialHash::rebuild() {
-    auto bounds = objectBounds_;
+    // 按对象顺序重新填充元素池，使格子链表重新紧凑
+    std::vector<Object> objects = std::move(objects_);
     clear();
-    
-    for (const auto& [node, bound] : bounds) {
-        insert(node, bound);
+    objects_.reserve(objects.size());
+
+    for (const Object& object : objects) {
+        insert(object.node, object.bounds);
     }
 }
 
 void SpatialHash::setCellSize(float cellSize) {
     if (cellSize != cellSize_ && cellSize > 0) {
         cellSize_ = cellSize;
+        inverseCellSize_ = 1.0f / cellSize;
         rebuild();
     }
 }
@@ -0,0 +1,109 @@
+#include <easy2d/spatial/spatial_index.h>
+#include <limits>
+
+namespace easy2d {
+
+namespace {
+
+void sortByFraction(std::vector<RaycastHit>& hits, size_t first) {
+    std::sort(hits.begin() + static_cast<std::ptrdiff_t>(first), hits.end(),
+        [](const RaycastHit& a, const RaycastHit& b) {
+            return a.fraction < b.fraction;
+        });
+}
+
+}
+
+// ============================================================================
+// 射线类查询 - 都建立在各索引的 castRay 上
+// ============================================================================
+bool ISpatialIndex::raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+    float length = direction.length();
+    if (length <= 0.0f || !(maxDistance > 0.0f)) {
+        return false;
+    }
+
+    Vec2 delta = direction * (maxDistance / length);
+    bool found = false;
+    castRay(SpatialRay(origin, delta), 1.0f, [&](Node* node, float t) {
+        // 相同距离时保留先找到的对象
+        if (!found || t < hit.fraction) {
+            hit.node = node;
+            hit.fraction = t;
+            found = true;
+        }
+        return t;
+    });
+
+    if (found) {
+        hit.distance = hit.fraction * maxDistance;
+        hit.point = origin + delta * hit.fraction;
+    }
+    return found;
+}
+
+void ISpatialIndex::raycastAll(const Vec2& origin, const Vec2& direction, float maxDistance,
+                               std::vector<RaycastHit>& hits) const {
+    float length = direction.length();
+    if (length <= 0.0f || !(maxDistance > 0.0f)) {
+        return;
+    }
+
+    Vec2 delta = direction * (maxDistance / length);
+    size_t first = hits.size();
+    castRay(SpatialRay(origin, delta), 1.0f, [&](Node* node, float t) {
+        hits.push_back(RaycastHit{node, t, t * maxDistance, origin + delta * t});
+        return 1.0f;
+    });
+    sortByFraction(hits, first);
+}
+
+void ISpatialIndex::querySegment(const Vec2& start, const Vec2& end, std::vector<Node*>& results) const {
+    castRay(SpatialRay(start, end - start), 1.0f, [&](Node* node, float) {
+        results.push_back(node);
+        return 1.0f;
+    });
+}
+
+void ISpatialIndex::querySwept(const Rect& box, const Vec2& displacement, std::vector<RaycastHit>& hits) const {
+    // 盒子缩为中心点，目标外扩盒子的半尺寸（闵可夫斯基和）
+    Vec2 extent(box.width() * 0.5f, box.height() * 0.5f);
+    Vec2 center = box.center();
+    float length = displacement.length();
+
+    size_t first = hits.size();
+    castRay(SpatialRay(center, displacement, extent), 1.0f, [&](Node* node, float t) {
+        hits.push_back(RaycastHit{node, t, t * length, center + displacement * t});
+        return 1.0f;
+    });
+    sortByFraction(hits, first);
+}
+
+// ============================================================================
+// 最近邻查询
+// ============================================================================
+void ISpatialIndex::queryNearest(const Vec2& point, size_t k, std::vector<SpatialNeighbor>& results) const {
+    queryNearest(point, k, [](Node*) { return true; }, results);
+}
+
+void ISpatialIndex::queryNearest(const Vec2& point, size_t k, SpatialFilter filter,
+                                 std::vector<SpatialNeighbor>& results) const {
+    if (k == 0) {
+        return;
+    }
+    collectNearest(point, k, std::numeric_limits<float>::infinity(), filter, results);
+}
+
+void ISpatialIndex::queryRadius(const Vec2& point, float radius, std::vector<SpatialNeighbor>& results) const {
+    queryRadius(point, radius, [](Node*) { return true; }, results);
+}
+
+void ISpatialIndex::queryRadius(const Vec2& point, float radius, SpatialFilter filter,
+                                std::vector<SpatialNeighbor>& results) const {
+    if (!(radius >= 0.0f)) {
+        return;
+    }
+    collectNearest(point, std::numeric_limits<size_t>::max(), radius, filter, results);
+}
+
+}
@@ -1,11 +1,42 @@
 #include <easy2d/spatial/spatial_manager.h>
 #include <easy2d/spatial/quadtree.h>
 #include <easy2d/spatial/spatial_hash.h>
+#include <easy2d/spatial/loose_quadtree.h>
+#include <easy2d/spatial/aabb_tree.h>
 #include <easy2d/scene/node.h>
 #include <chrono>
 
 namespace easy2d {
 
+namespace {
+
+// 开启统计时记录一次查询的次数与耗时，关闭时不读时钟
+class QueryTimer {
+public:
+    QueryTimer(bool enabled, size_t& count, uint64& total)
+        : enabled_(enabled), count_(count), total_(total) {
+        if (enabled_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~QueryTimer() {
+        if (enabled_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            count_++;
+            total_ += static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+private:
+    bool enabled_;
+    size_t& count_;
+    uint64& total_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
+
 SpatialManager::SpatialManager() 
     : worldBounds_(0, 0, 10000, 10000) {
     selectOptimalStrategy();
@@ -28,7 +59,7 @@ void SpatialManager::setAutoThresholds(size_t quadTreeThreshold, size_t hashThre
     hashThreshold_ = hashThreshold;
     
     if (currentStrategy_ == SpatialStrategy::Auto) {
-        selectOptimalStrategy();
+        rebuild();
     }
 }
 
@@ -41,65 +72,201 @@ void SpatialManager::insert(Node* node, const Rect& bounds) {
     if (!index_) {
         selectOptimalStrategy();
     }
+    // 四叉树会丢弃世界范围之外的对象，必须在写入前切换到 AABB 树
+    if (trackAutoOutlier(node, bounds) && !preferTree_) {
+        preferTree_ = true;
+        rebuildIndex();
+    }
     
     if (index_) {
         index_->insert(node, bounds);
     }
+    if (sweepAndPrune_) {
+        sweepAndPrune_->insert(node, bounds);
+    }
+    settleAutoStrategy();
 }
 
 void SpatialManager::remove(Node* node) {
+    if (!autoOutliers_.empty()) {
+        autoOutliers_.erase(node);
+    }
     if (index_) {
         index_->remove(node);
     }
+    if (sweepAndPrune_) {
+        sweepAndPrune_->remove(node);
+    }
+    settleAutoStrategy();
 }
 
 void SpatialManager::update(Node* node, const Rect& newBounds) {
+    if (trackAutoOutlier(node, newBounds) && !preferTree_) {
+        preferTree_ = true;
+        rebuildIndex();
+    }
     if (index_) {
         index_->update(node, newBounds);
     }
+    if (sweepAndPrune_) {
+        sweepAndPrune_->update(node, newBounds);
+    }
+    settleAutoStrategy();
 }
 
 std::vector<Node*> SpatialManager::query(const Rect& area) const {
-    if (!index_) return {};
-    
-    auto start = std::chrono::high_resolution_clock::now();
-    auto results = index_->query(area);
-    auto end = std::chrono::high_resolution_clock::now();
-    
-    queryCount_++;
-    totalQueryTime_ += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
-    
+    std::vector<Node*> results;
+    query(area, results);
     return results;
 }
 
 std::vector<Node*> SpatialManager::query(const Vec2& point) const {
-    if (!index_) return {};
-    return index_->query(point);
+    std::vector<Node*> results;
+    query(point, results);
+    return results;
+}
+
+void SpatialManager::query(const Rect& area, std::vector<Node*>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->query(area, results);
+}
+
+void SpatialManager::query(const Vec2& point, std::vector<Node*>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->query(point, results);
+}
+
+bool SpatialManager::visit(const Rect& area, SpatialVisitor visitor) const {
+    if (!index_) return true;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    return index_->visit(area, visitor);
+}
+
+bool SpatialManager::visit(const Vec2& point, SpatialVisitor visitor) const {
+    if (!index_) return true;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    return index_->visit(point, visitor);
+}
+
+bool SpatialManager::raycast(const Vec2& origin, const Vec2& direction, float maxDistance, RaycastHit& hit) const {
+    if (!index_) return false;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    return index_->raycast(origin, direction, maxDistance, hit);
+}
+
+void SpatialManager::raycastAll(const Vec2& origin, const Vec2& direction, float maxDistance,
+                                std::vector<RaycastHit>& hits) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->raycastAll(origin, direction, maxDistance, hits);
+}
+
+void SpatialManager::querySegment(const Vec2& start, const Vec2& end, std::vector<Node*>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->querySegment(start, end, results);
+}
+
+void SpatialManager::queryCircle(const Vec2& center, float radius, std::vector<Node*>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->queryCircle(center, radius, results);
+}
+
+void SpatialManager::querySwept(const Rect& box, const Vec2& displacement, std::vector<RaycastHit>& hits) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->querySwept(box, displacement, hits);
+}
+
+void SpatialManager::queryNearest(const Vec2& point, size_t k, std::vector<SpatialNeighbor>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->queryNearest(point, k, results);
+}
+
+void SpatialManager::queryNearest(const Vec2& point, size_t k, SpatialFilter filter,
+                                  std::vector<SpatialNeighbor>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->queryNearest(point, k, filter, results);
+}
+
+void SpatialManager::queryRadius(const Vec2& point, float radius, std::vector<SpatialNeighbor>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->queryRadius(point, radius, results);
+}
+
+void SpatialManager::queryRadius(const Vec2& point, float radius, SpatialFilter filter,
+                                 std::vector<SpatialNeighbor>& results) const {
+    if (!index_) return;
+    QueryTimer timer(instrumentationEnabled_, queryCount_, totalQueryTime_);
+    index_->queryRadius(point, radius, filter, results);
+}
+
+double SpatialManager::getTotalQueryTime() const {
+    return static_cast<double>(totalQueryTime_) / 1e6;
+}
+
+void SpatialManager::resetQueryStats() {
+    queryCount_ = 0;
+    totalQueryTime_ = 0;
 }
 
 std::vector<std::pair<Node*, Node*>> SpatialManager::queryCollisions() const {
+    if (sweepAndPrune_) {
+        sweepAndPrune_->updatePairs();
+        return sweepAndPrune_->getPairs();
+    }
     if (!index_) return {};
     return index_->queryCollisions();
 }
 
-void SpatialManager::query(const Rect& area, const QueryCallback& callback) const {
-    auto results = query(area);
-    for (Node* node : results) {
-        if (!callback(node)) break;
+void SpatialManager::setSweepAndPruneEnabled(bool enabled) {
+    if (enabled == isSweepAndPruneEnabled()) return;
+
+    if (!enabled) {
+        sweepAndPrune_.reset();
+        return;
+    }
+
+    sweepAndPrune_ = std::make_unique<SweepAndPrune>();
+    if (index_) {
+        index_->forEachObject([this](Node* node, const Rect& bounds) {
+            sweepAndPrune_->insert(node, bounds);
+        });
     }
 }
 
+const std::vector<CollisionEvent>& SpatialManager::getCollisionEvents() const {
+    static const std::vector<CollisionEvent> noEvents;
+    return sweepAndPrune_ ? sweepAndPrune_->getEvents() : noEvents;
+}
+
+void SpatialManager::query(const Rect& area, const QueryCallback& callback) const {
+    visit(area, callback);
+}
+
 void SpatialManager::query(const Vec2& point, const QueryCallback& callback) const {
-    auto results = query(point);
-    for (Node* node : results) {
-        if (!callback(node)) break;
-    }
+    visit(point, callback);
 }
 
 void SpatialManager::clear() {
-    if (index_) {
+    autoOutliers_.clear();
+    calmUpdates_ = 0;
+    if (preferTree_) {
+        // 对象已全部移除，Auto 回到按数量选择的策略
+        preferTree_ = false;
+        selectOptimalStrategy();
+    } else if (index_) {
         index_->clear();
     }
+    if (sweepAndPrune_) {
+        sweepAndPrune_->clear();
+    }
 }
 
 size_t SpatialManager::size() const {
@@ -111,29 +278,85 @@ bool SpatialManager::empty() const {
 }
 
 void SpatialManager::rebuild() {
+    // 世界范围或策略可能已改变，先按索引中的边界重新统计特殊对象
+    recountAutoOutliers();
+    rebuildIndex();
+}
+
+void SpatialManager::rebuildIndex() {
+    calmUpdates_ = 0;
     if (!index_) {
         selectOptimalStrategy();
         return;
     }
     
     auto oldIndex = std::move(index_);
-    selectOptimalStrategy();
+    selectOptimalStrategy(oldIndex->size());
     
     if (index_ && oldIndex) {
-        auto bounds = Rect(worldBounds_);
-        auto objects = oldIndex->query(bounds);
-        for (Node* node : objects) {
-            if (node) {
-                auto nodeBounds = node->getBoundingBox();
-                index_->insert(node, nodeBounds);
+        migrateFrom(*oldIndex);
+    }
+}
+
+void SpatialManager::migrateFrom(ISpatialIndex& oldIndex) {
+    // 使用旧索引登记的边界：节点当前的包围盒可能尚未提交，甚至节点正在析构
+    oldIndex.forEachObject([this](Node* node, const Rect& bounds) {
+        index_->insert(node, bounds);
+    });
+}
+
+bool SpatialManager::isAutoOutlier(const Rect& bounds) const {
+    // 四叉树会丢弃世界范围之外的对象，空间哈希在大对象上退化，两种情况都交给 AABB 树
+    bool large = std::max(bounds.size.width, bounds.size.height) > LARGE_OBJECT_EXTENT;
+    return large || !worldBounds_.contains(bounds);
+}
+
+bool SpatialManager::trackAutoOutlier(Node* node, const Rect& bounds) {
+    if (currentStrategy_ != SpatialStrategy::Auto) {
+        return false;
+    }
+    if (isAutoOutlier(bounds)) {
+        autoOutliers_.insert(node);
+        return true;
+    }
+    if (!autoOutliers_.empty()) {
+        autoOutliers_.erase(node);
+    }
+    return false;
+}
+
+void SpatialManager::settleAutoStrategy() {
+    if (!preferTree_) {
+        return;
+    }
+    if (!autoOutliers_.empty()) {
+        calmUpdates_ = 0;
+        return;
+    }
+    // 冷却期不短于对象数，重建的开销分摊到每次更新上为常数
+    if (++calmUpdates_ >= std::max(size(), AUTO_TREE_COOLDOWN)) {
+        preferTree_ = false;
+        rebuildIndex();
+    }
+}
+
+void SpatialManager::recountAutoOutliers() {
+    autoOutliers_.clear();
+    if (currentStrategy_ == SpatialStrategy::Auto && index_) {
+        index_->forEachObject([this](Node* node, const Rect& bounds) {
+            if (isAutoOutlier(bounds)) {
+                autoOutliers_.insert(node);
             }
-        }
+        });
     }
+    preferTree_ = !autoOutliers_.empty();
 }
 
 void SpatialManager::optimize() {
     if (currentStrategy_ == SpatialStrategy::Auto) {
-        selectOptimalStrategy();
+        // 按当前对象数量重新选择策略，并把对象迁移到新索引
+        rebuild();
+        return;
     }
     
     if (index_) {
@@ -149,6 +372,8 @@ const char* SpatialManager::getStrategyName() const {
     switch (activeStrategy_) {
         case SpatialStrategy::QuadTree: return "QuadTree";
         case SpatialStrategy::SpatialHash: return "SpatialHash";
+        case SpatialStrategy::LooseQuadTree: return "LooseQuadTree";
+        case SpatialStrategy::AABBTree: return "AABBTree";
         default: return "Unknown";
     }
 }
@@ -159,27 +384,27 @@ std::unique_ptr<ISpatialIndex> SpatialManager::createIndex(SpatialStrategy strat
             return std::make_unique<QuadTree>(bounds);
         case SpatialStrategy::SpatialHash:
             return std::make_unique<SpatialHash>(64.0f);
+        case SpatialStrategy::LooseQuadTree:
+            return std::make_unique<LooseQuadTree>(bounds);
+        case SpatialStrategy::AABBTree:
+            return std::make_unique<AABBTree>();
         default:
             return std::make_unique<QuadTree>(bounds);
     }
 }
 
-void SpatialManager::selectOptimalStrategy() {
+void SpatialManager::selectOptimalStrategy(size_t objectCount) {
     if (currentStrategy_ != SpatialStrategy::Auto) {
         activeStrategy_ = currentStrategy_;
-    } else {
-        size_t currentSize = index_ ? index_->size() : 0;
-        
-        if (currentSize < quadTreeThreshold_) {
-            activeStrategy_ = SpatialStrategy::QuadTree;
-        } else if (currentSize > hashThreshold_) {
-            activeStrategy_ = SpatialStrategy::SpatialHash;
-        } else {
-            // Keep current strategy in transition zone
-            if (!index_) {
-                activeStrategy_ = SpatialStrategy::QuadTree;
-            }
-        }
+    } else if (preferTree_) {
+        activeStrategy_ = SpatialStrategy::AABBTree;
+    } else if (objectCount < quadTreeThreshold_) {
+        activeStrategy_ = SpatialStrategy::QuadTree;
+    } else if (objectCount > hashThreshold_) {
+        activeStrategy_ = SpatialStrategy::SpatialHash;
+    } else if (activeStrategy_ != SpatialStrategy::QuadTree && activeStrategy_ != SpatialStrategy::SpatialHash) {
+        // 过渡区间内保持当前策略，之前为手动指定的其他策略时回到四叉树
+        activeStrategy_ = SpatialStrategy::QuadTree;
     }
     
     index_ = createIndex(activeStrategy_, worldBounds_);
@@ -0,0 +1,236 @@
+#include <easy2d/spatial/sweep_and_prune.h>
+#include <easy2d/scene/node.h>
+#include <algorithm>
+
+namespace easy2d {
+
+// ============================================================================
+// 代理管理
+// ============================================================================
+void SweepAndPrune::insert(Node* node, const Rect& bounds) {
+    if (!node) return;
+    if (lookup_.count(node)) {
+        update(node, bounds);
+        return;
+    }
+
+    int32 proxy;
+    if (freeProxy_ != INVALID) {
+        proxy = freeProxy_;
+        freeProxy_ = proxies_[proxy].nextFree;
+    } else {
+        proxy = static_cast<int32>(proxies_.size());
+        proxies_.emplace_back();
+    }
+
+    Proxy& entry = proxies_[proxy];
+    entry.node = node;
+    entry.bounds = bounds;
+    entry.nextFree = INVALID;
+    entry.alive = true;
+    lookup_[node] = proxy;
+
+    // 排序数组中的数据在 updatePairs 时从代理刷新
+    boxes_.push_back(Box{0.0f, 0.0f, 0.0f, 0.0f, proxy});
+    insertedSinceSort_++;
+}
+
+void SweepAndPrune::remove(Node* node) {
+    if (!node) return;
+    auto it = lookup_.find(node);
+    if (it == lookup_.end()) return;
+
+    proxies_[it->second].alive = false;
+    pendingFree_.push_back(it->second);
+    lookup_.erase(it);
+}
+
+void SweepAndPrune::update(Node* node, const Rect& newBounds) {
+    if (!node) return;
+    auto it = lookup_.find(node);
+    if (it == lookup_.end()) {
+        insert(node, newBounds);
+        return;
+    }
+    proxies_[it->second].bounds = newBounds;
+}
+
+void SweepAndPrune::clear() {
+    proxies_.clear();
+    freeProxy_ = INVALID;
+    pendingFree_.clear();
+    lookup_.clear();
+    boxes_.clear();
+    insertedSinceSort_ = 0;
+    pairKeys_.clear();
+    pairs_.clear();
+    events_.clear();
+}
+
+// ============================================================================
+// 每帧更新
+// ============================================================================
+void SweepAndPrune::updatePairs() {
+    chooseAxis();
+    refreshBoxes();
+    sortBoxes();
+
+    scratchKeys_.clear();
+    findPairs(scratchKeys_);
+    diffPairs(scratchKeys_);
+    pairKeys_.swap(scratchKeys_);
+
+    // 本轮移除的代理在配对归并之后才能复用
+    for (int32 proxy : pendingFree_) {
+        proxies_[proxy].node = nullptr;
+        proxies_[proxy].nextFree = freeProxy_;
+        freeProxy_ = proxy;
+    }
+    pendingFree_.clear();
+}
+
+void SweepAndPrune::chooseAxis() {
+    if (lookup_.size() < 2) {
+        return;
+    }
+
+    // 中心点方差较大的轴上投影重叠更少，扫描时的候选对也更少
+    double sum[2] = {0.0, 0.0};
+    double sumSquares[2] = {0.0, 0.0};
+    for (const Proxy& proxy : proxies_) {
+        if (!proxy.alive) {
+            continue;
+        }
+        double x = proxy.bounds.origin.x + proxy.bounds.size.width * 0.5f;
+        double y = proxy.bounds.origin.y + proxy.bounds.size.height * 0.5f;
+        sum[0] += x;
+        sum[1] += y;
+        sumSquares[0] += x * x;
+        sumSquares[1] += y * y;
+    }
+    double count = static_cast<double>(lookup_.size());
+    double variance[2];
+    for (int i = 0; i < 2; ++i) {
+        double mean = sum[i] / count;
+        variance[i] = sumSquares[i] / count - mean * mean;
+    }
+
+    // 留出余量，避免分布接近时来回切换导致整体重排
+    int other = 1 - axis_;
+    if (variance[other] > variance[axis_] * 1.5) {
+        axis_ = other;
+        fullSort_ = true;
+    }
+}
+
+void SweepAndPrune::refreshBoxes() {
+    size_t count = 0;
+    for (size_t i = 0; i < boxes_.size(); ++i) {
+        const Proxy& proxy = proxies_[boxes_[i].proxy];
+        if (!proxy.alive) {
+            continue;
+        }
+
+        const Rect& r = proxy.bounds;
+        Box& box = boxes_[count++];
+        box.proxy = boxes_[i].proxy;
+        if (axis_ == 0) {
+            box.min = r.origin.x;
+            box.max = r.origin.x + r.size.width;
+            box.otherMin = r.origin.y;
+            box.otherMax = r.origin.y + r.size.height;
+        } else {
+            box.min = r.origin.y;
+            box.max = r.origin.y + r.size.height;
+            box.otherMin = r.origin.x;
+            box.otherMax = r.origin.x + r.size.width;
+        }
+    }
+    boxes_.resize(count);
+}
+
+void SweepAndPrune::sortBoxes() {
+    // 大批量插入或切换轴后整体排序，否则插入排序只移动位置变化的包围盒
+    if (fullSort_ || insertedSinceSort_ > boxes_.size() / 8 + 16) {
+        std::sort(boxes_.begin(), boxes_.end(), [](const Box& a, const Box& b) {
+            return a.min < b.min;
+        });
+    } else {
+        for (size_t i = 1; i < boxes_.size(); ++i) {
+            if (boxes_[i - 1].min <= boxes_[i].min) {
+                continue;
+            }
+            Box box = boxes_[i];
+            size_t j = i;
+            while (j > 0 && boxes_[j - 1].min > box.min) {
+                boxes_[j] = boxes_[j - 1];
+                --j;
+            }
+            boxes_[j] = box;
+        }
+    }
+    fullSort_ = false;
+    insertedSinceSort_ = 0;
+}
+
+uint64 SweepAndPrune::makeKey(int32 a, int32 b) {
+    if (a > b) {
+        std::swap(a, b);
+    }
+    return (static_cast<uint64>(static_cast<uint32>(a)) << 32) | static_cast<uint32>(b);
+}
+
+void SweepAndPrune::findPairs(std::vector<uint64>& keys) const {
+    const size_t count = boxes_.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Box& a = boxes_[i];
+        for (size_t j = i + 1; j < count && boxes_[j].min <= a.max; ++j) {
+            const Box& b = boxes_[j];
+            if (b.otherMin <= a.otherMax && b.otherMax >= a.otherMin) {
+                keys.push_back(makeKey(a.proxy, b.proxy));
+            }
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+}
+
+void SweepAndPrune::diffPairs(const std::vector<uint64>& keys) {
+    events_.clear();
+    pairs_.clear();
+    pairs_.reserve(keys.size());
+
+    auto nodesOf = [this](uint64 key) {
+        int32 a = static_cast<int32>(key >> 32);
+        int32 b = static_cast<int32>(key & 0xffffffffu);
+        return std::make_pair(a, b);
+    };
+    auto emit = [&](uint64 key, CollisionPhase phase) {
+        auto [a, b] = nodesOf(key);
+        if (phase == CollisionPhase::End && (!proxies_[a].alive || !proxies_[b].alive)) {
+            return;
+        }
+        events_.push_back(CollisionEvent{proxies_[a].node, proxies_[b].node, phase});
+    };
+
+    // 两个升序键列表归并：只在新列表中为 Begin，只在旧列表中为 End，两者都有为 Persist
+    size_t i = 0;
+    size_t j = 0;
+    while (i < pairKeys_.size() || j < keys.size()) {
+        if (j == keys.size() || (i < pairKeys_.size() && pairKeys_[i] < keys[j])) {
+            emit(pairKeys_[i++], CollisionPhase::End);
+        } else if (i == pairKeys_.size() || keys[j] < pairKeys_[i]) {
+            emit(keys[j++], CollisionPhase::Begin);
+        } else {
+            emit(keys[j], CollisionPhase::Persist);
+            ++i;
+            ++j;
+        }
+    }
+
+    for (uint64 key : keys) {
+        auto [a, b] = nodesOf(key);
+        pairs_.emplace_back(proxies_[a].node, proxies_[b].node);
+    }
+}
+
+}
@@ -13,6 +13,17 @@ local SRC_DIR       = "src"
 local INC_DIR       = "include"
 local THIRD_PARTY   = "third_party"
 
+-- ==============================================
+-- 构建选项
+-- ==============================================
+-- 非原子引用计数（Ptr/WeakPtr 改用 RefPtr），仅适用于单线程访问场景的程序；
+-- 宏以 public 方式定义，库与依赖它的目标始终一致：xmake f --single_threaded_ptr=y
+option("single_threaded_ptr")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Use non-atomic reference counting for Ptr/WeakPtr (single-threaded scenes only)")
+option_end()
+
 -- ==============================================
 -- 1. Easy2D 静态库
 -- ==============================================
@@ -46,6 +57,9 @@ target("easy2d")
 
     -- 全平台宏定义
     add_defines("GLEW_STATIC")
+    if has_config("single_threaded_ptr") then
+        add_defines("E2D_SINGLE_THREADED_PTR", {public = true})
+    end
 
     -- ==============================================
     -- Windows 平台